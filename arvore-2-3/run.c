@@ -91,7 +91,7 @@ Node *adicionarNode(Node *noAtual, Node *novoNo)
     // Se a chave do nó atual é maior, move ela para a direita e coloca a nova chave na esquerda
     else
     {
-      noAtual->chaveNaDireita = strdup(noAtual->chaveNaEsquerda);
+      noAtual->chaveNaDireita = noAtual->chaveNaEsquerda;
       noAtual->chaveNaEsquerda = strdup(novoNo->chaveNaEsquerda);
       // Reorganiza os ponteiros
       noAtual->ponteiroDaDireita = noAtual->ponteiroDoMeio;
@@ -454,8 +454,8 @@ void freeArvore(Arvore *arvore)
 }
 
 #define MAX_HEIGHT 10
-#define LARGURA_TELA 80
-#define ALTURA_TELA 20
+#define ESPACO_ENTRE_NOS 2
+#define LINHAS_POR_NIVEL 3
 
 typedef struct
 {
@@ -464,14 +464,57 @@ typedef struct
   int largura;
 } TelaVisualizacao;
 
+// Quantidade de filhos de um nó: folha (0), nó com uma chave (2) ou com duas chaves (3)
+int contarFilhos(Node *node)
+{
+  if (verificaSeNodeEhFolha(node))
+    return 0;
+  return node->chaveNaDireita ? 3 : 2;
+}
+
+// Retorna o i-ésimo filho (0 = esquerda, 1 = meio, 2 = direita)
+Node *obterFilho(Node *node, int i)
+{
+  if (i == 0)
+    return node->ponteiroDaEsquerda;
+  if (i == 1)
+    return node->ponteiroDoMeio;
+  return node->ponteiroDaDireita;
+}
+
+// Largura do texto "[A]" ou "[A|B]" de um nó, considerando o tamanho real das palavras
+int calcularLarguraNo(Node *node)
+{
+  int largura = strlen(node->chaveNaEsquerda) + 2;
+  if (node->chaveNaDireita)
+    largura += strlen(node->chaveNaDireita) + 1;
+  return largura;
+}
+
 // Função auxiliar para calcular o centro de um nó
 int calcularCentroNo(Node *node)
 {
-  if (node->chaveNaDireita)
+  return calcularLarguraNo(node) / 2;
+}
+
+// Largura que a subárvore ocupa na tela: o maior valor entre o próprio nó
+// e a soma das larguras dos filhos (com um espaço entre eles)
+int calcularLarguraSubarvore(Node *node)
+{
+  if (!node)
+    return 0;
+
+  int larguraFilhos = 0;
+  int filhos = contarFilhos(node);
+  for (int i = 0; i < filhos; i++)
   {
-    return 5; // [A|B] = 5 caracteres
+    if (i > 0)
+      larguraFilhos += ESPACO_ENTRE_NOS;
+    larguraFilhos += calcularLarguraSubarvore(obterFilho(node, i));
   }
-  return 3; // [A] = 3 caracteres
+
+  int larguraNo = calcularLarguraNo(node);
+  return larguraFilhos > larguraNo ? larguraFilhos : larguraNo;
 }
 
 void desenharNo(TelaVisualizacao *tela, Node *node, int linha, int coluna)
@@ -479,18 +522,19 @@ void desenharNo(TelaVisualizacao *tela, Node *node, int linha, int coluna)
   if (!node)
     return;
 
-  char nodeStr[10];
+  // O texto é montado com o tamanho exato das chaves, sem buffer fixo
+  int len = calcularLarguraNo(node);
+  char *nodeStr = malloc(len + 1);
   if (node->chaveNaDireita)
   {
-    sprintf(nodeStr, "[%s|%s]", node->chaveNaEsquerda, node->chaveNaDireita);
+    snprintf(nodeStr, len + 1, "[%s|%s]", node->chaveNaEsquerda, node->chaveNaDireita);
   }
   else
   {
-    sprintf(nodeStr, "[%s]", node->chaveNaEsquerda);
+    snprintf(nodeStr, len + 1, "[%s]", node->chaveNaEsquerda);
   }
 
   // Centraliza o nó na posição
-  int len = strlen(nodeStr);
   int start = coluna - len / 2;
   for (int i = 0; i < len; i++)
   {
@@ -499,90 +543,122 @@ void desenharNo(TelaVisualizacao *tela, Node *node, int linha, int coluna)
       tela->tela[linha][start + i] = nodeStr[i];
     }
   }
+  free(nodeStr);
 }
 
+// Liga o pai ao filho nas linhas intermediárias: '|' quando o filho está logo abaixo,
+// '/' quando está à esquerda e '\' quando está à direita
 void desenharConexoes(TelaVisualizacao *tela, int linhaPai, int colunaPai,
-                      int linhaFilho, int colunaFilho, bool ehMeio, bool ehNoPaiDuplo)
+                      int linhaFilho, int colunaFilho)
 {
-  if (ehMeio)
+  int distancia = colunaFilho - colunaPai;
+  char simbolo = '|';
+  if (distancia < 0)
+    simbolo = '/';
+  else if (distancia > 0)
+    simbolo = '\\';
+
+  for (int i = 1; i < linhaFilho - linhaPai; i++)
   {
-    // Centraliza a linha vertical baseado no tipo do nó pai
-    int ajuste = ehNoPaiDuplo ? 0 : 1;
-    for (int i = 1; i < linhaFilho - linhaPai; i++)
+    int col = colunaPai + (i * distancia) / (linhaFilho - linhaPai);
+    if (col >= 0 && col < tela->largura)
     {
-      tela->tela[linhaPai + i][colunaPai + ajuste] = '|';
-    }
-  }
-  else
-  {
-    int distancia = abs(colunaFilho - colunaPai);
-    int direcao = (colunaFilho < colunaPai) ? -1 : 1;
-    // Sempre usa '/' para esquerda e '\' para direita, independente do tipo de nó
-    char simbolo = (direcao < 0) ? '/' : '\\';
-
-    // Ajusta o ponto inicial para nós simples
-    if (!ehNoPaiDuplo)
-    {
-      colunaPai += (direcao < 0) ? -1 : 1;
-    }
-
-    for (int i = 1; i < linhaFilho - linhaPai; i++)
-    {
-      int col = colunaPai + (direcao * i * distancia) / (linhaFilho - linhaPai);
-      if (col >= 0 && col < tela->largura)
-      {
-        tela->tela[linhaPai + i][col] = simbolo;
-      }
+      tela->tela[linhaPai + i][col] = simbolo;
     }
   }
 }
 
-void desenharArvoreRecursivo(TelaVisualizacao *tela, Node *node, int nivel, int coluna)
+// Desenha a subárvore dentro do intervalo de colunas [inicio, inicio + largura da subárvore).
+// O nó fica centralizado no intervalo e os filhos são distribuídos lado a lado abaixo dele.
+void desenharArvoreRecursivo(TelaVisualizacao *tela, Node *node, int nivel, int inicio)
 {
   if (!node)
     return;
 
-  int linha = nivel * 3;
-  bool ehNoDuplo = node->chaveNaDireita != NULL;
+  int linha = nivel * LINHAS_POR_NIVEL;
+  int largura = calcularLarguraSubarvore(node);
+  int coluna = inicio + largura / 2;
   desenharNo(tela, node, linha, coluna);
 
-  if (!verificaSeNodeEhFolha(node))
-  {
-    int espacamento = 20 / (nivel + 1);
+  int filhos = contarFilhos(node);
+  if (filhos == 0)
+    return;
 
-    // Ajusta espaçamento baseado no tipo do nó
-    if (!ehNoDuplo)
-    {
-      espacamento = (espacamento * 4) / 5;
-    }
+  int larguras[3];
+  int larguraFilhos = 0;
+  for (int i = 0; i < filhos; i++)
+  {
+    larguras[i] = calcularLarguraSubarvore(obterFilho(node, i));
+    larguraFilhos += larguras[i] + (i > 0 ? ESPACO_ENTRE_NOS : 0);
+  }
 
-    int colunaEsq = coluna - espacamento;
-    int colunaDir = coluna + espacamento;
+  // Centraliza o grupo de filhos abaixo do nó
+  int colunaFilho = inicio + (largura - larguraFilhos) / 2;
+  for (int i = 0; i < filhos; i++)
+  {
+    desenharArvoreRecursivo(tela, obterFilho(node, i), nivel + 1, colunaFilho);
+    desenharConexoes(tela, linha, coluna, linha + LINHAS_POR_NIVEL, colunaFilho + larguras[i] / 2);
+    colunaFilho += larguras[i] + ESPACO_ENTRE_NOS;
+  }
+}
 
-    // Desenha filho esquerdo
-    desenharArvoreRecursivo(tela, node->ponteiroDaEsquerda, nivel + 1, colunaEsq);
-    desenharConexoes(tela, linha, coluna, linha + 3, colunaEsq, false, ehNoDuplo);
+// Visualização resumida para árvores que não cabem na tela:
+// mostra a raiz e quantos nós/chaves existem em cada nível
+void imprimirResumoArvore(Node *raiz, int altura)
+{
+  long *nos = calloc(altura, sizeof(long));
+  long *nosDuplos = calloc(altura, sizeof(long));
+
+  // Percurso em profundidade com pilha explícita (memória proporcional à altura)
+  int capacidade = altura * 3 + 1;
+  Node **pilha = malloc(capacidade * sizeof(Node *));
+  int *niveis = malloc(capacidade * sizeof(int));
+  int topo = 0;
+  pilha[topo] = raiz;
+  niveis[topo++] = 0;
+
+  while (topo > 0)
+  {
+    topo--;
+    Node *atual = pilha[topo];
+    int nivel = niveis[topo];
 
-    if (ehNoDuplo)
-    {
-      // Para nó duplo [A|B]:
-      // - ponteiroDoMeio liga com a primeira chave
-      // - ponteiroDaDireita liga com a segunda chave
-      desenharArvoreRecursivo(tela, node->ponteiroDoMeio, nivel + 1, coluna);
-      desenharConexoes(tela, linha, coluna, linha + 3, coluna, true, ehNoDuplo);
+    nos[nivel]++;
+    if (atual->chaveNaDireita)
+      nosDuplos[nivel]++;
 
-      desenharArvoreRecursivo(tela, node->ponteiroDaDireita, nivel + 1, colunaDir);
-      desenharConexoes(tela, linha, coluna, linha + 3, colunaDir, false, ehNoDuplo);
-    }
-    else
+    for (int i = contarFilhos(atual) - 1; i >= 0; i--)
     {
-      // Para nó simples [A]:
-      // - ponteiroDoMeio é tratado como filho direito
-      // - ponteiroDaDireita não é usado
-      desenharArvoreRecursivo(tela, node->ponteiroDoMeio, nivel + 1, colunaDir);
-      desenharConexoes(tela, linha, coluna, linha + 3, colunaDir, false, ehNoDuplo);
+      Node *filho = obterFilho(atual, i);
+      if (filho && nivel + 1 < altura && topo < capacidade)
+      {
+        pilha[topo] = filho;
+        niveis[topo++] = nivel + 1;
+      }
     }
   }
+
+  printf("\n=== Árvore 2-3 (resumo: grande demais para desenhar) ===\n\n");
+  if (raiz->chaveNaDireita)
+    printf("Raiz: [%s|%s]\n", raiz->chaveNaEsquerda, raiz->chaveNaDireita);
+  else
+    printf("Raiz: [%s]\n", raiz->chaveNaEsquerda);
+  printf("Altura: %d\n", altura);
+
+  long totalNos = 0, totalChaves = 0;
+  for (int i = 0; i < altura; i++)
+  {
+    long chaves = nos[i] + nosDuplos[i];
+    printf("Nível %2d: %ld nós (%ld com 2 chaves), %ld chaves\n", i, nos[i], nosDuplos[i], chaves);
+    totalNos += nos[i];
+    totalChaves += chaves;
+  }
+  printf("Total: %ld nós, %ld chaves\n", totalNos, totalChaves);
+
+  free(pilha);
+  free(niveis);
+  free(nos);
+  free(nosDuplos);
 }
 
 void imprimirArvore(Node *raiz)
@@ -593,22 +669,30 @@ void imprimirArvore(Node *raiz)
     return;
   }
 
+  // A tela é dimensionada pela própria árvore; se passar dos limites, mostra o resumo
+  int altura = calcularAltura(raiz);
+  int largura = calcularLarguraSubarvore(raiz);
+  if (altura > MAX_HEIGHT || largura > MAX_WIDTH)
+  {
+    imprimirResumoArvore(raiz, altura);
+    return;
+  }
+
   TelaVisualizacao *tela = malloc(sizeof(TelaVisualizacao));
-  tela->altura = ALTURA_TELA;
-  tela->largura = LARGURA_TELA;
+  tela->altura = (altura - 1) * LINHAS_POR_NIVEL + 1;
+  tela->largura = largura;
 
   // Inicializa a tela com espaços
-  tela->tela = malloc(ALTURA_TELA * sizeof(char *));
-  for (int i = 0; i < ALTURA_TELA; i++)
+  tela->tela = malloc(tela->altura * sizeof(char *));
+  for (int i = 0; i < tela->altura; i++)
   {
-    tela->tela[i] = malloc(LARGURA_TELA * sizeof(char));
-    memset(tela->tela[i], ' ', LARGURA_TELA);
+    tela->tela[i] = malloc(tela->largura * sizeof(char));
+    memset(tela->tela[i], ' ', tela->largura);
   }
 
   printf("\n=== Árvore 2-3 ===\n\n");
 
-  // Começa o desenho no centro da tela
-  desenharArvoreRecursivo(tela, raiz, 0, LARGURA_TELA / 2);
+  desenharArvoreRecursivo(tela, raiz, 0, 0);
 
   // Imprime a visualização
   for (int i = 0; i < tela->altura; i++)
@@ -641,6 +725,164 @@ void imprimirArvore(Node *raiz)
   free(tela);
 }
 
+// Escreve o texto escapando os caracteres especiais de DOT/JSON (aspas, barra e controle)
+void escreverTextoEscapado(FILE *saida, const char *chave)
+{
+  for (const unsigned char *c = (const unsigned char *)chave; *c; c++)
+  {
+    if (*c == '"' || *c == '\\')
+    {
+      fputc('\\', saida);
+      fputc(*c, saida);
+    }
+    else if (*c < 0x20)
+      fprintf(saida, "\\u%04x", *c);
+    else
+      fputc(*c, saida);
+  }
+}
+
+// Escreve uma chave entre aspas, já escapada
+void escreverChaveEscapada(FILE *saida, const char *chave)
+{
+  fputc('"', saida);
+  escreverTextoEscapado(saida, chave);
+  fputc('"', saida);
+}
+
+// Escreve a declaração de um nó no DOT: n<id> [label="[A|B]"];
+void escreverNoDot(FILE *saida, Node *node, long id)
+{
+  fprintf(saida, "  n%ld [label=\"[", id);
+  escreverTextoEscapado(saida, node->chaveNaEsquerda);
+  if (node->chaveNaDireita)
+  {
+    fputc('|', saida);
+    escreverTextoEscapado(saida, node->chaveNaDireita);
+  }
+  fprintf(saida, "]\"];\n");
+}
+
+// Quadro da pilha usada nas exportações: guarda o nó, qual filho visitar a seguir
+// e o identificador do nó no arquivo DOT
+typedef struct
+{
+  Node *no;
+  int proximoFilho;
+  long id;
+} QuadroExportacao;
+
+// Pilha de quadros que cresce sob demanda; na árvore 2-3 ela nunca passa da altura
+typedef struct
+{
+  QuadroExportacao *quadros;
+  int topo;
+  int capacidade;
+} PilhaExportacao;
+
+void empilharQuadro(PilhaExportacao *pilha, Node *no, long id)
+{
+  if (pilha->topo == pilha->capacidade)
+  {
+    pilha->capacidade = pilha->capacidade ? pilha->capacidade * 2 : 32;
+    pilha->quadros = realloc(pilha->quadros, pilha->capacidade * sizeof(QuadroExportacao));
+  }
+  pilha->quadros[pilha->topo].no = no;
+  pilha->quadros[pilha->topo].proximoFilho = 0;
+  pilha->quadros[pilha->topo].id = id;
+  pilha->topo++;
+}
+
+// Exporta a árvore no formato Graphviz DOT.
+// Percorre a árvore uma única vez com pilha explícita: tempo linear e memória proporcional à altura,
+// então funciona para árvores com milhões de nós. Gere a imagem com: dot -Tsvg arvore.dot -o arvore.svg
+void exportarDot(Node *raiz, FILE *saida)
+{
+  fprintf(saida, "digraph Arvore23 {\n");
+  fprintf(saida, "  node [shape=box, fontname=\"monospace\"];\n");
+
+  PilhaExportacao pilha = {NULL, 0, 0};
+  long proximoId = 0;
+  if (raiz)
+  {
+    escreverNoDot(saida, raiz, proximoId);
+    empilharQuadro(&pilha, raiz, proximoId++);
+  }
+
+  while (pilha.topo > 0)
+  {
+    QuadroExportacao *quadro = &pilha.quadros[pilha.topo - 1];
+    if (quadro->proximoFilho >= contarFilhos(quadro->no))
+    {
+      pilha.topo--;
+      continue;
+    }
+
+    Node *filho = obterFilho(quadro->no, quadro->proximoFilho++);
+    if (!filho)
+      continue;
+
+    long id = proximoId++;
+    escreverNoDot(saida, filho, id);
+    fprintf(saida, "  n%ld -> n%ld;\n", quadro->id, id);
+    empilharQuadro(&pilha, filho, id);
+  }
+
+  fprintf(saida, "}\n");
+  free(pilha.quadros);
+}
+
+// Abre o objeto JSON de um nó: {"chaves":["A","B"],"filhos":[
+void escreverNoJson(FILE *saida, Node *node)
+{
+  fprintf(saida, "{\"chaves\":[");
+  escreverChaveEscapada(saida, node->chaveNaEsquerda);
+  if (node->chaveNaDireita)
+  {
+    fputc(',', saida);
+    escreverChaveEscapada(saida, node->chaveNaDireita);
+  }
+  fprintf(saida, "],\"filhos\":[");
+}
+
+// Exporta a árvore em JSON aninhado ({"chaves":[...],"filhos":[...]}).
+// Mesmo percurso da exportação DOT: linear e com memória proporcional à altura.
+void exportarJson(Node *raiz, FILE *saida)
+{
+  if (!raiz)
+  {
+    fprintf(saida, "null\n");
+    return;
+  }
+
+  PilhaExportacao pilha = {NULL, 0, 0};
+  empilharQuadro(&pilha, raiz, 0);
+  escreverNoJson(saida, raiz);
+
+  while (pilha.topo > 0)
+  {
+    QuadroExportacao *quadro = &pilha.quadros[pilha.topo - 1];
+    if (quadro->proximoFilho >= contarFilhos(quadro->no))
+    {
+      fprintf(saida, "]}");
+      pilha.topo--;
+      continue;
+    }
+
+    Node *filho = obterFilho(quadro->no, quadro->proximoFilho++);
+    if (!filho)
+      continue;
+
+    if (quadro->proximoFilho > 1)
+      fputc(',', saida);
+    escreverNoJson(saida, filho);
+    empilharQuadro(&pilha, filho, 0);
+  }
+
+  fputc('\n', saida);
+  free(pilha.quadros);
+}
+
 // Por enquanto, o delete exclui toda a árvore e cria uma nova com os valores antigos MENOS o valor que é para ser deletado.
 Node *reconstruirArvore(Arvore *arvore, const char *palavraRemovida)
 {
@@ -661,7 +903,361 @@ Node *reconstruirArvore(Arvore *arvore, const char *palavraRemovida)
   return novaRaiz;
 }
 
+// Adiciona uma palavra nova na lista de palavras e na árvore.
+// Retorna false se a palavra já existe.
+bool adicionarPalavra(Arvore *arvore, const char *palavra)
+{
+  for (int i = 0; i < arvore->quantidadePalavras; i++)
+  {
+    if (strcmp(arvore->palavras[i], palavra) == 0)
+      return false;
+  }
+
+  // Verifica se precisa aumentar o array
+  if (arvore->quantidadePalavras >= arvore->capacidadePalavras)
+  {
+    int novaCapacidade = arvore->capacidadePalavras * 2;
+    char **novasPalavras = realloc(arvore->palavras, sizeof(char *) * novaCapacidade);
+    if (!novasPalavras)
+    {
+      printf("Erro de alocação de memória!\n");
+      return false;
+    }
+    arvore->palavras = novasPalavras;
+    arvore->capacidadePalavras = novaCapacidade;
+  }
+
+  // Adiciona a palavra no array
+  arvore->palavras[arvore->quantidadePalavras] = strdup(palavra);
+  arvore->quantidadePalavras++;
+
+  // Insere a palavra
+  arvore->raiz = inserirNaArvore(arvore, palavra, arvore->raiz);
+  return true;
+}
+
+// Remove a palavra da lista de palavras e reconstrói a árvore sem ela.
+// Retorna false se a palavra não existe.
+bool removerPalavra(Arvore *arvore, const char *palavra)
+{
+  bool palavraEncontrada = false;
+  for (int i = 0; i < arvore->quantidadePalavras; i++)
+  {
+    if (strcmp(arvore->palavras[i], palavra) == 0)
+    {
+      palavraEncontrada = true;
+      free(arvore->palavras[i]);
+
+      // Move todas as palavras uma posição para trás
+      for (int j = i; j < arvore->quantidadePalavras - 1; j++)
+      {
+        arvore->palavras[j] = arvore->palavras[j + 1];
+      }
+      arvore->quantidadePalavras--;
+      break;
+    }
+  }
+
+  if (!palavraEncontrada)
+    return false;
+
+  // Libera a árvore atual e reconstrói
+  freeNode(arvore->raiz);
+  arvore->raiz = reconstruirArvore(arvore, palavra);
+  return true;
+}
 
+// Busca silenciosa (sem imprimir o percurso), usada pelo validador e pelo fuzz
+bool contemNaArvore(Node *noAtual, const char *value)
+{
+  while (noAtual != NULL)
+  {
+    int comparacao = strcmp(value, noAtual->chaveNaEsquerda);
+    if (comparacao == 0)
+      return true;
+    if (comparacao < 0)
+    {
+      noAtual = noAtual->ponteiroDaEsquerda;
+      continue;
+    }
+    if (noAtual->chaveNaDireita == NULL)
+    {
+      noAtual = noAtual->ponteiroDoMeio;
+      continue;
+    }
+    comparacao = strcmp(value, noAtual->chaveNaDireita);
+    if (comparacao == 0)
+      return true;
+    noAtual = comparacao < 0 ? noAtual->ponteiroDoMeio : noAtual->ponteiroDaDireita;
+  }
+  return false;
+}
+
+// Verifica recursivamente um nó e sua subárvore.
+// 'minimo' e 'maximo' são os limites (exclusivos) que as chaves da subárvore devem respeitar.
+// 'nivelFolhas' guarda a profundidade da primeira folha encontrada; todas as outras devem ser iguais.
+bool validarNo(Node *node, const char *minimo, const char *maximo, int nivel, int *nivelFolhas, long *chaves)
+{
+  if (node->chaveNaEsquerda == NULL)
+  {
+    fprintf(stderr, "[VALIDACAO] Nó no nível %d sem chave na esquerda\n", nivel);
+    return false;
+  }
+
+  // Ordenação: minimo < esquerda < direita < maximo
+  if ((minimo && strcmp(node->chaveNaEsquerda, minimo) <= 0) ||
+      (maximo && strcmp(node->chaveNaEsquerda, maximo) >= 0))
+  {
+    fprintf(stderr, "[VALIDACAO] Chave '%s' fora do intervalo permitido\n", node->chaveNaEsquerda);
+    return false;
+  }
+  if (node->chaveNaDireita)
+  {
+    if (strcmp(node->chaveNaEsquerda, node->chaveNaDireita) >= 0 ||
+        (maximo && strcmp(node->chaveNaDireita, maximo) >= 0))
+    {
+      fprintf(stderr, "[VALIDACAO] Chaves [%s|%s] fora de ordem\n", node->chaveNaEsquerda, node->chaveNaDireita);
+      return false;
+    }
+  }
+  *chaves += node->chaveNaDireita ? 2 : 1;
+
+  // Folhas: todas na mesma profundidade
+  if (verificaSeNodeEhFolha(node))
+  {
+    if (*nivelFolhas < 0)
+      *nivelFolhas = nivel;
+    if (*nivelFolhas != nivel)
+    {
+      fprintf(stderr, "[VALIDACAO] Folha '%s' no nível %d, esperado %d\n", node->chaveNaEsquerda, nivel, *nivelFolhas);
+      return false;
+    }
+    return true;
+  }
+
+  // Nó interno: 2-nó tem exatamente 2 filhos (sem terceiro filho pendurado), 3-nó tem exatamente 3
+  if (node->ponteiroDaEsquerda == NULL || node->ponteiroDoMeio == NULL)
+  {
+    fprintf(stderr, "[VALIDACAO] Nó interno '%s' com filho faltando\n", node->chaveNaEsquerda);
+    return false;
+  }
+  if (node->chaveNaDireita == NULL && node->ponteiroDaDireita != NULL)
+  {
+    fprintf(stderr, "[VALIDACAO] Nó '%s' com uma chave e terceiro filho pendurado\n", node->chaveNaEsquerda);
+    return false;
+  }
+  if (node->chaveNaDireita != NULL && node->ponteiroDaDireita == NULL)
+  {
+    fprintf(stderr, "[VALIDACAO] Nó [%s|%s] sem o terceiro filho\n", node->chaveNaEsquerda, node->chaveNaDireita);
+    return false;
+  }
+
+  if (!validarNo(node->ponteiroDaEsquerda, minimo, node->chaveNaEsquerda, nivel + 1, nivelFolhas, chaves))
+    return false;
+  if (node->chaveNaDireita == NULL)
+    return validarNo(node->ponteiroDoMeio, node->chaveNaEsquerda, maximo, nivel + 1, nivelFolhas, chaves);
+  if (!validarNo(node->ponteiroDoMeio, node->chaveNaEsquerda, node->chaveNaDireita, nivel + 1, nivelFolhas, chaves))
+    return false;
+  return validarNo(node->ponteiroDaDireita, node->chaveNaDireita, maximo, nivel + 1, nivelFolhas, chaves);
+}
+
+// Verifica as invariantes da árvore 2-3:
+// - chaves em ordem (esquerda < direita e respeitando os limites do pai)
+// - todas as folhas na mesma profundidade
+// - nós com uma chave não têm terceiro filho; nós internos têm todos os filhos
+// - a quantidade de chaves é igual a 'chavesEsperadas' (use -1 para não conferir)
+// Custo O(n), pode ser usada como pós-condição em benchmarks.
+bool validarArvore(Node *raiz, long chavesEsperadas)
+{
+  long chaves = 0;
+  int nivelFolhas = -1;
+
+  if (raiz != NULL && !validarNo(raiz, NULL, NULL, 0, &nivelFolhas, &chaves))
+    return false;
+
+  if (chavesEsperadas >= 0 && chaves != chavesEsperadas)
+  {
+    fprintf(stderr, "[VALIDACAO] Árvore tem %ld chaves, esperado %ld\n", chaves, chavesEsperadas);
+    return false;
+  }
+  return true;
+}
+
+// Conjunto de referência (vetor ordenado) usado para conferir a árvore durante o fuzz
+typedef struct
+{
+  char **itens;
+  int quantidade;
+  int capacidade;
+} ConjuntoReferencia;
+
+// Busca binária: retorna a posição da palavra ou onde ela deveria ser inserida
+int posicaoNoConjunto(ConjuntoReferencia *conjunto, const char *palavra, bool *encontrada)
+{
+  int inicio = 0, fim = conjunto->quantidade;
+  while (inicio < fim)
+  {
+    int meio = (inicio + fim) / 2;
+    int comparacao = strcmp(conjunto->itens[meio], palavra);
+    if (comparacao == 0)
+    {
+      *encontrada = true;
+      return meio;
+    }
+    if (comparacao < 0)
+      inicio = meio + 1;
+    else
+      fim = meio;
+  }
+  *encontrada = false;
+  return inicio;
+}
+
+// Interpreta os bytes como uma sequência de operações (inserir, buscar, deletar) com palavras curtas
+// de um alfabeto pequeno, para forçar repetições, splits e remoções de palavras existentes.
+// Depois de cada operação confere a árvore com o conjunto de referência e com validarArvore.
+// Qualquer divergência aborta o programa, que é o que os fuzzers (libFuzzer/AFL) detectam.
+void executarFuzz(const unsigned char *dados, size_t tamanho)
+{
+  Arvore *arvore = CriarArvore();
+  ConjuntoReferencia referencia = {NULL, 0, 0};
+  char palavra[8];
+  size_t i = 0;
+
+  while (i + 1 < tamanho)
+  {
+    int operacao = dados[i] % 4;
+    int comprimento = 1 + (dados[i] >> 2) % 3;
+    i++;
+
+    int k;
+    for (k = 0; k < comprimento && i < tamanho; k++, i++)
+      palavra[k] = 'a' + dados[i] % 8;
+    palavra[k] = '\0';
+
+    bool encontrada;
+    int posicao = posicaoNoConjunto(&referencia, palavra, &encontrada);
+
+    if (operacao <= 1)
+    {
+      bool inserida = adicionarPalavra(arvore, palavra);
+      if (inserida == encontrada)
+      {
+        fprintf(stderr, "[FUZZ] Inserção de '%s' divergiu da referência\n", palavra);
+        abort();
+      }
+      if (inserida)
+      {
+        if (referencia.quantidade == referencia.capacidade)
+        {
+          referencia.capacidade = referencia.capacidade ? referencia.capacidade * 2 : 16;
+          referencia.itens = realloc(referencia.itens, referencia.capacidade * sizeof(char *));
+        }
+        memmove(&referencia.itens[posicao + 1], &referencia.itens[posicao],
+                (referencia.quantidade - posicao) * sizeof(char *));
+        referencia.itens[posicao] = strdup(palavra);
+        referencia.quantidade++;
+      }
+    }
+    else if (operacao == 2)
+    {
+      if (contemNaArvore(arvore->raiz, palavra) != encontrada)
+      {
+        fprintf(stderr, "[FUZZ] Busca de '%s' divergiu da referência\n", palavra);
+        abort();
+      }
+    }
+    else
+    {
+      bool removida = removerPalavra(arvore, palavra);
+      if (removida != encontrada)
+      {
+        fprintf(stderr, "[FUZZ] Remoção de '%s' divergiu da referência\n", palavra);
+        abort();
+      }
+      if (removida)
+      {
+        free(referencia.itens[posicao]);
+        memmove(&referencia.itens[posicao], &referencia.itens[posicao + 1],
+                (referencia.quantidade - posicao - 1) * sizeof(char *));
+        referencia.quantidade--;
+      }
+    }
+
+    if (!validarArvore(arvore->raiz, referencia.quantidade))
+      abort();
+  }
+
+  // Ao final, todas as palavras da referência devem estar na árvore
+  for (int j = 0; j < referencia.quantidade; j++)
+  {
+    if (!contemNaArvore(arvore->raiz, referencia.itens[j]))
+    {
+      fprintf(stderr, "[FUZZ] Palavra '%s' sumiu da árvore\n", referencia.itens[j]);
+      abort();
+    }
+    free(referencia.itens[j]);
+  }
+  free(referencia.itens);
+  freeArvore(arvore);
+}
+
+#ifdef FUZZ_ARVORE
+// Ponto de entrada do libFuzzer: clang -g -fsanitize=fuzzer,address -DFUZZ_ARVORE run.c
+int LLVMFuzzerTestOneInput(const unsigned char *dados, size_t tamanho)
+{
+  executarFuzz(dados, tamanho);
+  return 0;
+}
+#endif
+
+// Executa o fuzz com o conteúdo de um arquivo (modo usado pelo AFL: afl-fuzz ... -- ./run --fuzz @@)
+int executarFuzzArquivo(const char *nomeArquivo)
+{
+  FILE *arquivo = fopen(nomeArquivo, "rb");
+  if (!arquivo)
+  {
+    printf("Erro ao abrir '%s'!\n", nomeArquivo);
+    return 1;
+  }
+
+  size_t capacidade = 4096, tamanho = 0, lidos;
+  unsigned char *dados = malloc(capacidade);
+  while ((lidos = fread(dados + tamanho, 1, capacidade - tamanho, arquivo)) > 0)
+  {
+    tamanho += lidos;
+    if (tamanho == capacidade)
+    {
+      capacidade *= 2;
+      dados = realloc(dados, capacidade);
+    }
+  }
+  fclose(arquivo);
+
+  executarFuzz(dados, tamanho);
+  free(dados);
+  return 0;
+}
+
+// Gera sequências aleatórias de operações e executa o fuzz com elas
+int executarFuzzAleatorio(int rodadas, unsigned int semente)
+{
+  unsigned char dados[512];
+  srand(semente);
+  clock_t startTime = clock();
+
+  for (int r = 0; r < rodadas; r++)
+  {
+    size_t tamanho = 1 + rand() % sizeof(dados);
+    for (size_t i = 0; i < tamanho; i++)
+      dados[i] = rand() & 0xFF;
+    executarFuzz(dados, tamanho);
+  }
+
+  printf("Fuzz: %d rodadas sem divergências (semente %u) em %f s\n", rodadas, semente,
+         (double)(clock() - startTime) / CLOCKS_PER_SEC);
+  return 0;
+}
 
 int obterEntradaUsuario(Arvore *arvore)
 {
@@ -673,6 +1269,7 @@ int obterEntradaUsuario(Arvore *arvore)
   printf("2 para procurar algum elemento\n");
   printf("3 para deletar\n");
   printf("4 para percorrer a árvore\n");
+  printf("5 para exportar a árvore (DOT ou JSON)\n");
   printf("Opção: ");
 
   if (scanf("%d", &opcao) != 1)
@@ -692,43 +1289,12 @@ int obterEntradaUsuario(Arvore *arvore)
       return 0;
     }
 
-    bool palavraExiste = false;
-    for (int i = 0; i < arvore->quantidadePalavras; i++)
-    {
-      if (strcmp(arvore->palavras[i], palavra) == 0)
-      {
-        palavraExiste = true;
-        break;
-      }
-    }
-
-    if (palavraExiste)
+    if (!adicionarPalavra(arvore, palavra))
     {
       printf("Palavra '%s' já existe na árvore!\n", palavra);
       return 0;
     }
 
-    // Verifica se precisa aumentar o array
-    if (arvore->quantidadePalavras >= arvore->capacidadePalavras)
-    {
-      int novaCapacidade = arvore->capacidadePalavras * 2;
-      char **novasPalavras = realloc(arvore->palavras, sizeof(char *) * novaCapacidade);
-      if (!novasPalavras)
-      {
-        printf("Erro de alocação de memória!\n");
-        return 0;
-      }
-      arvore->palavras = novasPalavras;
-      arvore->capacidadePalavras = novaCapacidade;
-    }
-
-    // Adiciona a palavra no array
-    arvore->palavras[arvore->quantidadePalavras] = strdup(palavra);
-    arvore->quantidadePalavras++;
-    
-    // Insere a palavra
-    arvore->raiz = inserirNaArvore(arvore, palavra, arvore->raiz);
-
     printf("Palavra '%s' inserida com sucesso!\n", palavra);
   }
   else if (opcao == 2)
@@ -763,34 +1329,13 @@ int obterEntradaUsuario(Arvore *arvore)
       return 0;
     }
 
-    // Verifica se a palavra existe e a remove do array
-    bool palavraEncontrada = buscarNaArvore(arvore->raiz, palavra);
-    for (int i = 0; i < arvore->quantidadePalavras; i++)
-    {
-      if (strcmp(arvore->palavras[i], palavra) == 0)
-      {
-        palavraEncontrada = true;
-        free(arvore->palavras[i]);
-
-        // Move todas as palavras uma posição para trás
-        for (int j = i; j < arvore->quantidadePalavras - 1; j++)
-        {
-          arvore->palavras[j] = arvore->palavras[j + 1];
-        }
-        arvore->quantidadePalavras--;
-        break;
-      }
-    }
-
-    if (!palavraEncontrada)
+    buscarNaArvore(arvore->raiz, palavra);
+    if (!removerPalavra(arvore, palavra))
     {
       printf("Palavra '%s' não encontrada na árvore!\n", palavra);
       return 0;
     }
 
-    // Libera a árvore atual e reconstrói
-    freeNode(arvore->raiz);
-    arvore->raiz = reconstruirArvore(arvore, palavra);
     printf("Palavra '%s' deletada com sucesso!\n", palavra);
   }
   else if (opcao == 4)
@@ -830,6 +1375,44 @@ int obterEntradaUsuario(Arvore *arvore)
     }
     printf("\n");
   }
+  else if (opcao == 5)
+  {
+    printf("\nEscolha o formato:\n");
+    printf("1 - Graphviz DOT\n");
+    printf("2 - JSON\n");
+    printf("Opção: ");
+
+    int formato;
+    if (scanf("%d", &formato) != 1 || (formato != 1 && formato != 2))
+    {
+      while (getchar() != '\n')
+        ;
+      printf("Entrada inválida!\n");
+      return 0;
+    }
+
+    char nomeArquivo[256];
+    printf("Nome do arquivo de saída: ");
+    if (scanf("%255s", nomeArquivo) != 1)
+    {
+      printf("Erro na leitura do nome do arquivo!\n");
+      return 0;
+    }
+
+    FILE *saida = fopen(nomeArquivo, "w");
+    if (!saida)
+    {
+      printf("Erro ao criar o arquivo '%s'!\n", nomeArquivo);
+      return 0;
+    }
+
+    if (formato == 1)
+      exportarDot(arvore->raiz, saida);
+    else
+      exportarJson(arvore->raiz, saida);
+    fclose(saida);
+    printf("Árvore exportada para '%s'!\n", nomeArquivo);
+  }
   else
   {
     printf("Opção inválida!\n");
@@ -838,8 +1421,15 @@ int obterEntradaUsuario(Arvore *arvore)
   return 0;
 }
 
+#ifndef FUZZ_ARVORE
 int main(int argc, char *argv[])
 {
+  // Modos de verificação: ./run --fuzz <arquivo> ou ./run --fuzz-aleatorio <rodadas> [semente]
+  if (argc >= 3 && strcmp(argv[1], "--fuzz") == 0)
+    return executarFuzzArquivo(argv[2]);
+  if (argc >= 3 && strcmp(argv[1], "--fuzz-aleatorio") == 0)
+    return executarFuzzAleatorio(atoi(argv[2]), argc >= 4 ? (unsigned int)atoi(argv[3]) : (unsigned int)time(NULL));
+
   Arvore *arvore = CriarArvore();
   FILE *input = fopen("input.txt", "r");
 
@@ -867,3 +1457,4 @@ int main(int argc, char *argv[])
   }
   return 0;
 }
+#endif
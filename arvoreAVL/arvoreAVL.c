@@ -1,14 +1,33 @@
 // Programa em C para implementar a Árvore AVL com interação do usuário
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 // Estrutura do nó da Árvore AVL
+// 'tamanho' é o número de nós da subárvore: permite posição (rank), seleção e contagem de
+// intervalos em O(log n). Compilar com -DAVL_SEM_TAMANHO remove o campo e essas consultas.
 struct No
 {
   int chave;
   struct No *esquerda;
   struct No *direita;
   int altura;
+#ifndef AVL_SEM_TAMANHO
+  int tamanho;
+#endif
 };
 
 
@@ -20,8 +39,28 @@ int obterAltura(struct No *n)
     return 0;
   return n->altura;
 }
+
+#ifndef AVL_SEM_TAMANHO
+// Função para obter o número de nós da subárvore
+int obterTamanho(struct No *n)
+{
+  if (n == NULL)
+    return 0;
+  return n->tamanho;
+}
+
+// Recalcula o tamanho de um nó a partir dos filhos (chamada junto com cada atualização de altura)
+void atualizarTamanho(struct No *n)
+{
+  n->tamanho = 1 + obterTamanho(n->esquerda) + obterTamanho(n->direita);
+}
+#else
+#define atualizarTamanho(n) ((void)0)
+#endif
 struct No *remover(struct No *raiz, int chave);
 struct No *noValorMinimo(struct No *no);
+struct No *balancearNo(struct No *no);
+int removerIterativo(struct No **raizPtr, int chave);
 
 // Função para criar um novo nó
 struct No *criarNo(int chave)
@@ -31,11 +70,13 @@ struct No *criarNo(int chave)
   no->esquerda = NULL;
   no->direita = NULL;
   no->altura = 1;
+  atualizarTamanho(no);
   return no;
 }
 
 // Função utilitária para obter o máximo entre dois números inteiros
 int max(int a, int b) { return (a > b) ? a : b; }
+int min(int a, int b) { return (a < b) ? a : b; }
 
 // Função para obter o fator de balanceamento de um nó
 // Descrição:
@@ -64,7 +105,7 @@ int obterFatorBalanceamento(struct No *n)
 //     x(T2) passa a ser o filho esquerdo de y.
 //    x se torna a nova raiz da subárvore e 
 //    y passa a ser seu filho direito.
-//    As alturas dos nós são atualizadas.
+//    As alturas (e os tamanhos) dos nós são atualizadas.
 
     struct No *
     rotacaoDireita(struct No *y)
@@ -75,6 +116,8 @@ int obterFatorBalanceamento(struct No *n)
   y->esquerda = T2;
   y->altura = max(obterAltura(y->esquerda), obterAltura(y->direita)) + 1;
   x->altura = max(obterAltura(x->esquerda), obterAltura(x->direita)) + 1;
+  atualizarTamanho(y);
+  atualizarTamanho(x);
   return x;
 }
 
@@ -87,7 +130,7 @@ int obterFatorBalanceamento(struct No *n)
 // y se torna a nova raiz da subárvore.
 // O filho esquerdo de y (T2) passa a ser o filho direito de x.
 // y se torna a nova raiz e x passa a ser seu filho esquerdo.
-// As alturas dos nós são atualizadas.
+// As alturas (e os tamanhos) dos nós são atualizadas.
 
 struct No *rotacaoEsquerda(struct No *x)
 {
@@ -97,6 +140,8 @@ struct No *rotacaoEsquerda(struct No *x)
   x->direita = T2;
   x->altura = max(obterAltura(x->esquerda), obterAltura(x->direita)) + 1;
   y->altura = max(obterAltura(y->esquerda), obterAltura(y->direita)) + 1;
+  atualizarTamanho(x);
+  atualizarTamanho(y);
   return y;
 }
 
@@ -124,6 +169,7 @@ struct No *inserir(struct No *no, int chave)
   else
     return no;
   no->altura = 1 + max(obterAltura(no->esquerda), obterAltura(no->direita));
+  atualizarTamanho(no);
   int balanceamento = obterFatorBalanceamento(no);
   if (balanceamento > 1 && chave < no->esquerda->chave)
     return rotacaoDireita(no);
@@ -224,16 +270,26 @@ struct No *noValorMinimo(struct No *no)
 }
 
 // Função para remover um nó com chave específica da árvore AVL
+// Uma única descida encontra, desliga e rebalanceia (ver removerIterativo), sem buscar() antes.
 int removerNo(struct No **raizPtr, int chave)
 {
-  // Primeiro verifica se o valor existe na árvore
-  if (buscar(*raizPtr, chave) == NULL)
-    return 0; // Valor não encontrado
+  return removerIterativo(raizPtr, chave); // 1 se encontrou e removeu, 0 se não existia
+}
 
-  // Se o valor existe, realiza a remoção
-  *raizPtr = remover(*raizPtr, chave);
+// Função para desligar o nó mínimo de uma subárvore
+// Descrição:
+// Remove da subárvore o nó mais à esquerda sem liberá-lo e o devolve em *minimo,
+// rebalanceando o caminho na volta. Retorna a nova raiz da subárvore.
 
-  return 1; // Valor encontrado e removido
+struct No *removerMinimo(struct No *raiz, struct No **minimo)
+{
+  if (raiz->esquerda == NULL)
+  {
+    *minimo = raiz;
+    return raiz->direita;
+  }
+  raiz->esquerda = removerMinimo(raiz->esquerda, minimo);
+  return balancearNo(raiz);
 }
 
 
@@ -246,19 +302,20 @@ int removerNo(struct No **raizPtr, int chave)
 // Caso a chave seja menor, chama remover() para a subárvore esquerda.
 // Caso a chave seja maior, chama remover() para a subárvore direita.
 // Caso contrário, encontrou o nó a ser removido:
-// Se tiver um ou nenhum filho, ajusta os ponteiros e libera a memória.
-// Se tiver dois filhos, encontra o menor valor da subárvore direita, copia a chave para o nó atual e remove o sucessor.
+// Se tiver um ou nenhum filho, o filho (ou NULL) ocupa o lugar dele e o nó é liberado.
+// Se tiver dois filhos, o sucessor é desligado da subárvore direita e religado no lugar do nó.
 // Atualiza a altura do nó.
 // Verifica o balanceamento e aplica rotações, se necessário.
 
 
 // Quando removemos um nó que tem dois filhos, seguimos esses passos:
 
-// Encontramos o menor valor da subárvore direita (o sucessor in-order).
-// Copiamos esse valor para o nó que estamos removendo.
-// Removemos o sucessor real da árvore.
-// Atualizamos a altura do nó.
-// Verificamos o balanceamento e aplicamos rotações se necessário.
+// Desligamos o menor nó da subárvore direita (o sucessor in-order), rebalanceando essa subárvore.
+// O sucessor herda os dois filhos do nó removido e passa a ocupar o lugar dele.
+// Atualizamos a altura e verificamos o balanceamento, aplicando rotações se necessário.
+
+// Nenhum nó tem o conteúdo copiado para outro: os nós que continuam na árvore são os mesmos,
+// então ponteiros guardados fora da árvore (por exemplo, retornados por buscar()) continuam válidos.
 
 
 struct No *remover(struct No *raiz, int chave)
@@ -281,31 +338,23 @@ struct No *remover(struct No *raiz, int chave)
     // Caso 1: Nó com um filho ou sem filhos
     if ((raiz->esquerda == NULL) || (raiz->direita == NULL))
     {
-      struct No *temp = raiz->esquerda ? raiz->esquerda : raiz->direita;
-
-      // Caso sem filhos
-      if (temp == NULL)
-      {
-        temp = raiz;
-        raiz = NULL;
-      }
-      // Caso com um filho
-      else
-        *raiz = *temp; // Copia o conteúdo do filho não-nulo
-
-      free(temp);
+      // O filho (ou NULL) sobe para o lugar do nó; a subárvore dele já está balanceada
+      struct No *filho = raiz->esquerda ? raiz->esquerda : raiz->direita;
+      free(raiz);
+      return filho;
     }
     // Caso 2: Nó com dois filhos
     else
     {
-      // Encontrar o sucessor in-order (menor nó na subárvore direita)
-      struct No *temp = noValorMinimo(raiz->direita);
-
-      // Copiar a chave do sucessor para este nó
-      raiz->chave = temp->chave;
-
-      // Remover o sucessor
-      raiz->direita = remover(raiz->direita, temp->chave);
+      // Desligar o sucessor in-order (menor nó na subárvore direita)
+      struct No *sucessor;
+      struct No *direita = removerMinimo(raiz->direita, &sucessor);
+
+      // O sucessor assume os filhos e o lugar do nó removido
+      sucessor->esquerda = raiz->esquerda;
+      sucessor->direita = direita;
+      free(raiz);
+      raiz = sucessor;
     }
   }
 
@@ -315,6 +364,7 @@ struct No *remover(struct No *raiz, int chave)
 
   // Passo 2: Atualizar a altura do nó atual
   raiz->altura = 1 + max(obterAltura(raiz->esquerda), obterAltura(raiz->direita));
+  atualizarTamanho(raiz);
 
   // Passo 3: Verificar o fator de balanceamento deste nó para ver se ficou desbalanceado
   int balanceamento = obterFatorBalanceamento(raiz);
@@ -344,76 +394,2162 @@ struct No *remover(struct No *raiz, int chave)
   return raiz;
 }
 
-int main()
+// Altura máxima que a pilha de caminho comporta. Uma árvore AVL com n nós tem altura
+// menor que 1.45 * log2(n + 2), então 64 níveis bastam para qualquer quantidade de nós endereçável.
+#define MAX_ALTURA_AVL 64
+
+// Função para rebalancear um nó (usada pelas versões iterativas)
+// Descrição:
+// Atualiza a altura do nó e, se ele estiver desbalanceado, aplica a rotação simples ou dupla adequada.
+
+// Lógica:
+
+// Fator > 1: a subárvore esquerda está alta demais. Se o filho esquerdo pende para a direita
+// (caso Esquerda-Direita), primeiro gira o filho à esquerda; depois gira o nó à direita.
+// Fator < -1: simétrico.
+// Retorna a nova raiz da subárvore.
+
+struct No *balancearNo(struct No *no)
 {
-  struct No *raiz = NULL;
-  int opcao, chave;
-  raiz = inserir(raiz, 1);
-  raiz = inserir(raiz, 2);
-  raiz = inserir(raiz, 4);
-  raiz = inserir(raiz, 5);
-  raiz = inserir(raiz, 6);
-  raiz = inserir(raiz, 3);
+  no->altura = 1 + max(obterAltura(no->esquerda), obterAltura(no->direita));
+  atualizarTamanho(no);
+  int balanceamento = obterFatorBalanceamento(no);
 
-  do
+  if (balanceamento > 1)
   {
-    printf("\nMenu:\n");
-    printf("1. Inserir\n");
-    printf("2. Remover\n");
-    printf("3. Buscar\n");
-    printf("4. Exibir pré-ordem\n");
-    printf("5. Exibir em ordem\n");
-    printf("6. Exibir pós-ordem\n");
-    printf("7. Exibir árvore\n");
-    printf("8. Sair\n");
-    printf("Escolha uma opcao: ");
-    scanf("%d", &opcao);
-    switch (opcao)
+    if (obterFatorBalanceamento(no->esquerda) < 0)
+      no->esquerda = rotacaoEsquerda(no->esquerda);
+    return rotacaoDireita(no);
+  }
+  if (balanceamento < -1)
+  {
+    if (obterFatorBalanceamento(no->direita) > 0)
+      no->direita = rotacaoDireita(no->direita);
+    return rotacaoEsquerda(no);
+  }
+  return no;
+}
+
+// Recalcula o tamanho dos nós caminho[0..topo-1], de baixo para cima. A volta do rebalanceamento
+// para assim que uma altura não muda, mas todos os ancestrais ganharam (ou perderam) um nó.
+void atualizarTamanhosCaminho(struct No ***caminho, int topo)
+{
+#ifndef AVL_SEM_TAMANHO
+  while (topo > 0)
+    atualizarTamanho(*caminho[--topo]);
+#else
+  (void)caminho;
+  (void)topo;
+#endif
+}
+
+// Função para inserir uma chave sem recursão
+// Descrição:
+// Mesmo resultado de inserir(), mas a descida guarda numa pilha de tamanho fixo os endereços
+// dos ponteiros percorridos (raiz, ->esquerda ou ->direita), então não precisa de ponteiro para o pai.
+
+// Lógica:
+
+// Desce até a posição vazia empilhando cada ponteiro e pendura ali o novo nó.
+// Na volta, desempilha atualizando as alturas:
+//  - se a altura de um nó não mudou, nada acima dele muda e a volta termina;
+//  - se um nó ficou desbalanceado, uma rotação (simples ou dupla) devolve a subárvore à altura
+//    que tinha antes da inserção, então também termina: no máximo uma rotação por inserção.
+// Retorna 1 se inseriu, 0 se a chave já existia.
+
+int inserirIterativo(struct No **raizPtr, int chave)
+{
+  struct No **caminho[MAX_ALTURA_AVL];
+  int topo = 0;
+  struct No **link = raizPtr;
+
+  while (*link != NULL)
+  {
+    if (chave == (*link)->chave)
+      return 0;
+    caminho[topo++] = link;
+    link = chave < (*link)->chave ? &(*link)->esquerda : &(*link)->direita;
+  }
+  *link = criarNo(chave);
+
+  while (topo > 0)
+  {
+    link = caminho[--topo];
+    struct No *no = *link;
+    int alturaAntiga = no->altura;
+    int balanceamento = obterFatorBalanceamento(no);
+
+    if (balanceamento > 1 || balanceamento < -1)
     {
-    case 1:
-      printf("Digite o valor a ser inserido: ");
-      scanf("%d", &chave);
-      raiz = inserir(raiz, chave);
-      break;
-    case 2:
-      printf("Digite o valor a ser removido: ");
-      scanf("%d", &chave);
-      raiz = remover(raiz, chave);
-      printf("Valor removido (se existir).\n");
+      *link = balancearNo(no);
       break;
-    case 3:
-      printf("Digite o valor a ser buscado: ");
-      scanf("%d", &chave);
-      if (buscar(raiz, chave) != NULL)
-        printf("Valor encontrado!\n");
-      else
-        printf("Valor nao encontrado.\n");
+    }
+    no->altura = 1 + max(obterAltura(no->esquerda), obterAltura(no->direita));
+    atualizarTamanho(no);
+    if (no->altura == alturaAntiga)
       break;
-    case 4:
-      printf("Percurso pré-ordem: ");
-      preOrdem(raiz);
-      printf("\n");
+  }
+  atualizarTamanhosCaminho(caminho, topo);
+  return 1;
+}
+
+// Função para remover uma chave sem recursão
+// Descrição:
+// Mesmo resultado de removerNo(), com a mesma pilha de ponteiros de inserirIterativo().
+
+// Lógica:
+
+// Desce até a chave empilhando o caminho. Se o nó tem um filho ou nenhum, o filho (ou NULL)
+// ocupa o lugar dele. Se tem dois, continua descendo até o sucessor in-order (menor nó da
+// subárvore direita), desliga o sucessor e o religa no lugar do nó, com os filhos do nó.
+// Nenhum conteúdo é copiado entre nós, então ponteiros externos para os nós que ficam continuam válidos.
+// Na volta, rebalanceia e para assim que a subárvore de um nó ficar com a mesma altura de antes
+// (na remoção uma rotação pode diminuir a altura, então a volta pode continuar depois dela).
+// Retorna 1 se removeu, 0 se a chave não existia.
+
+int removerIterativo(struct No **raizPtr, int chave)
+{
+  struct No **caminho[MAX_ALTURA_AVL];
+  int topo = 0;
+  struct No **link = raizPtr;
+
+  while (*link != NULL && (*link)->chave != chave)
+  {
+    caminho[topo++] = link;
+    link = chave < (*link)->chave ? &(*link)->esquerda : &(*link)->direita;
+  }
+  if (*link == NULL)
+    return 0;
+
+  struct No *no = *link;
+  if (no->esquerda != NULL && no->direita != NULL)
+  {
+    int indiceAlvo = topo;
+    caminho[topo++] = link;
+    struct No **linkSucessor = &no->direita;
+    while ((*linkSucessor)->esquerda != NULL)
+    {
+      caminho[topo++] = linkSucessor;
+      linkSucessor = &(*linkSucessor)->esquerda;
+    }
+    struct No *sucessor = *linkSucessor;
+    *linkSucessor = sucessor->direita;
+
+    sucessor->esquerda = no->esquerda;
+    sucessor->direita = no->direita;
+    sucessor->altura = no->altura;
+    *link = sucessor;
+    // A entrada logo abaixo do alvo apontava para o campo 'direita' do nó que será liberado
+    if (indiceAlvo + 1 < topo)
+      caminho[indiceAlvo + 1] = &sucessor->direita;
+  }
+  else
+  {
+    *link = no->esquerda != NULL ? no->esquerda : no->direita;
+  }
+  free(no);
+
+  while (topo > 0)
+  {
+    link = caminho[--topo];
+    no = *link;
+    int alturaAntiga = no->altura;
+    *link = balancearNo(no);
+    if ((*link)->altura == alturaAntiga)
       break;
-    case 5:
-      printf("Percurso em ordem: ");
-      emOrdem(raiz);
-      printf("\n");
+  }
+  atualizarTamanhosCaminho(caminho, topo);
+  return 1;
+}
+
+// Função para liberar todos os nós da árvore
+void liberarArvore(struct No *raiz)
+{
+  if (raiz == NULL)
+    return;
+  liberarArvore(raiz->esquerda);
+  liberarArvore(raiz->direita);
+  free(raiz);
+}
+
+// ---------------------------------------------------------------------------
+// Árvore AVL compacta: os nós ficam num vetor contíguo e os filhos são índices de 32 bits
+// nesse vetor (o índice 0 é reservado e faz o papel de NULL). Em vez da altura, cada nó guarda
+// só o fator de balanceamento (-1, 0 ou 1): são 2 bits de informação, e o nó inteiro ocupa
+// 16 bytes contra os 32 de struct No, então cabem 4 nós por linha de cache de 64 bytes em vez de 2.
+// Como não há ponteiros, o vetor pode ser realocado, gravado em arquivo e mapeado de volta
+// com mmap sem nenhuma correção de endereços.
+// ---------------------------------------------------------------------------
+
+struct NoCompacto
+{
+  int chave;
+  uint32_t esquerda;
+  uint32_t direita;
+  int8_t balanceamento; // altura(esquerda) - altura(direita)
+};
+
+struct ArvoreCompacta
+{
+  struct NoCompacto *nos;
+  uint32_t quantidade;  // posições usadas do vetor, incluindo a posição 0 reservada
+  uint32_t capacidade;
+  uint32_t raiz;        // 0 = árvore vazia
+  uint32_t livre;       // lista de posições liberadas, encadeadas pelo campo 'esquerda'
+  uint32_t numChaves;
+  void *mapeamento;     // diferente de NULL quando 'nos' aponta para um arquivo mapeado
+  size_t tamanhoMapeamento;
+};
+
+// Cabeçalho do arquivo, seguido diretamente dos 'quantidade' nós do vetor
+struct CabecalhoArvoreCompacta
+{
+  char magica[8];
+  uint32_t quantidade;
+  uint32_t raiz;
+  uint32_t livre;
+  uint32_t numChaves;
+};
+
+#define MAGICA_ARVORE_COMPACTA "AVLCMP1"
+
+// Função para criar uma árvore compacta vazia
+struct ArvoreCompacta *criarArvoreCompacta()
+{
+  struct ArvoreCompacta *arvore = (struct ArvoreCompacta *)calloc(1, sizeof(struct ArvoreCompacta));
+  arvore->capacidade = 16;
+  arvore->nos = (struct NoCompacto *)calloc(arvore->capacidade, sizeof(struct NoCompacto));
+  arvore->quantidade = 1;
+  return arvore;
+}
+
+void liberarArvoreCompacta(struct ArvoreCompacta *arvore)
+{
+  if (arvore == NULL)
+    return;
+  if (arvore->mapeamento != NULL)
+  {
+#ifdef _WIN32
+    free(arvore->mapeamento);
+#else
+    munmap(arvore->mapeamento, arvore->tamanhoMapeamento);
+#endif
+  }
+  else
+  {
+    free(arvore->nos);
+  }
+  free(arvore);
+}
+
+// Função para obter uma posição livre do vetor para um novo nó
+// Descrição:
+// Reaproveita uma posição da lista de livres ou usa a próxima posição do vetor, dobrando a
+// capacidade quando ele enche. Se o vetor ainda é o arquivo mapeado, ele é copiado para a
+// memória antes de crescer. Como os filhos são índices, a realocação não invalida nada.
+// Retorna o índice do nó (os índices guardados em variáveis continuam válidos, mas ponteiros
+// para arvore->nos não).
+
+uint32_t criarNoCompacto(struct ArvoreCompacta *arvore, int chave)
+{
+  uint32_t indice;
+  if (arvore->livre != 0)
+  {
+    indice = arvore->livre;
+    arvore->livre = arvore->nos[indice].esquerda;
+  }
+  else
+  {
+    if (arvore->quantidade == arvore->capacidade)
+    {
+      uint32_t novaCapacidade = arvore->capacidade * 2;
+      struct NoCompacto *novos;
+      if (arvore->mapeamento != NULL)
+      {
+        novos = (struct NoCompacto *)malloc(novaCapacidade * sizeof(struct NoCompacto));
+        memcpy(novos, arvore->nos, arvore->quantidade * sizeof(struct NoCompacto));
+#ifdef _WIN32
+        free(arvore->mapeamento);
+#else
+        munmap(arvore->mapeamento, arvore->tamanhoMapeamento);
+#endif
+        arvore->mapeamento = NULL;
+      }
+      else
+      {
+        novos = (struct NoCompacto *)realloc(arvore->nos, novaCapacidade * sizeof(struct NoCompacto));
+      }
+      arvore->nos = novos;
+      arvore->capacidade = novaCapacidade;
+    }
+    indice = arvore->quantidade++;
+  }
+
+  // Zera o nó inteiro (inclusive os bytes de alinhamento depois de 'balanceamento'): as posições
+  // novas vêm do realloc sem inicializar, e o vetor vai como está para o arquivo
+  struct NoCompacto *no = &arvore->nos[indice];
+  memset(no, 0, sizeof(struct NoCompacto));
+  no->chave = chave;
+  return indice;
+}
+
+// Rotações da árvore compacta
+// Descrição:
+// Mesmas rotações de rotacaoDireita() e rotacaoEsquerda(), mas sem alturas: os novos fatores
+// de balanceamento saem dos antigos. Na rotação à direita de y (com filho esquerdo x):
+//   y' = y - 1 - max(x, 0)      x' = x - 1 + min(y', 0)
+// e simetricamente na rotação à esquerda. As fórmulas valem para qualquer fator dos dois nós,
+// então servem tanto para as rotações simples quanto para as duas metades de uma rotação dupla.
+
+uint32_t rotacaoDireitaCompacta(struct NoCompacto *nos, uint32_t y)
+{
+  uint32_t x = nos[y].esquerda;
+  nos[y].esquerda = nos[x].direita;
+  nos[x].direita = y;
+  nos[y].balanceamento = nos[y].balanceamento - 1 - max(nos[x].balanceamento, 0);
+  nos[x].balanceamento = nos[x].balanceamento - 1 + min(nos[y].balanceamento, 0);
+  return x;
+}
+
+uint32_t rotacaoEsquerdaCompacta(struct NoCompacto *nos, uint32_t x)
+{
+  uint32_t y = nos[x].direita;
+  nos[x].direita = nos[y].esquerda;
+  nos[y].esquerda = x;
+  nos[x].balanceamento = nos[x].balanceamento + 1 - min(nos[y].balanceamento, 0);
+  nos[y].balanceamento = nos[y].balanceamento + 1 + max(nos[x].balanceamento, 0);
+  return y;
+}
+
+// Rebalanceia um nó com fator 2 ou -2 (rotação simples ou dupla) e retorna a nova raiz da subárvore
+uint32_t balancearNoCompacto(struct NoCompacto *nos, uint32_t no)
+{
+  if (nos[no].balanceamento > 1)
+  {
+    if (nos[nos[no].esquerda].balanceamento < 0)
+      nos[no].esquerda = rotacaoEsquerdaCompacta(nos, nos[no].esquerda);
+    return rotacaoDireitaCompacta(nos, no);
+  }
+  if (nos[nos[no].direita].balanceamento > 0)
+    nos[no].direita = rotacaoDireitaCompacta(nos, nos[no].direita);
+  return rotacaoEsquerdaCompacta(nos, no);
+}
+
+// Liga 'filho' no lugar apontado pela entrada 'i' do caminho (ou na raiz, se i < 0)
+void religarCompacta(struct ArvoreCompacta *arvore, uint32_t *caminho, int *lados, int i, uint32_t filho)
+{
+  if (i < 0)
+    arvore->raiz = filho;
+  else if (lados[i] == 0)
+    arvore->nos[caminho[i]].esquerda = filho;
+  else
+    arvore->nos[caminho[i]].direita = filho;
+}
+
+// Função para buscar uma chave na árvore compacta
+// Retorna o índice do nó (0 se a chave não existe).
+uint32_t buscarCompacta(struct ArvoreCompacta *arvore, int chave)
+{
+  uint32_t atual = arvore->raiz;
+  while (atual != 0 && arvore->nos[atual].chave != chave)
+    atual = chave < arvore->nos[atual].chave ? arvore->nos[atual].esquerda : arvore->nos[atual].direita;
+  return atual;
+}
+
+// Função para inserir uma chave na árvore compacta
+// Descrição:
+// Mesmo percurso de inserirIterativo(), com uma pilha de índices e o lado tomado em cada nó.
+
+// Lógica:
+
+// Na volta, o fator de cada nó aumenta (veio pela esquerda) ou diminui (pela direita):
+//  - se ficou 0, a altura do nó não mudou e a volta termina;
+//  - se ficou 1 ou -1, a altura aumentou e a volta continua;
+//  - se ficou 2 ou -2, uma rotação devolve a subárvore à altura anterior e a volta termina.
+// Retorna 1 se inseriu, 0 se a chave já existia.
+
+int inserirCompacta(struct ArvoreCompacta *arvore, int chave)
+{
+  uint32_t caminho[MAX_ALTURA_AVL];
+  int lados[MAX_ALTURA_AVL];
+  int topo = 0;
+  uint32_t atual = arvore->raiz;
+
+  while (atual != 0)
+  {
+    if (chave == arvore->nos[atual].chave)
+      return 0;
+    caminho[topo] = atual;
+    lados[topo] = chave < arvore->nos[atual].chave ? 0 : 1;
+    atual = lados[topo] == 0 ? arvore->nos[atual].esquerda : arvore->nos[atual].direita;
+    topo++;
+  }
+  // criarNoCompacto() pode realocar o vetor: os ponteiros para os nós só são obtidos depois
+  uint32_t novo = criarNoCompacto(arvore, chave);
+  religarCompacta(arvore, caminho, lados, topo - 1, novo);
+  arvore->numChaves++;
+
+  struct NoCompacto *nos = arvore->nos;
+  while (topo > 0)
+  {
+    uint32_t no = caminho[--topo];
+    nos[no].balanceamento += lados[topo] == 0 ? 1 : -1;
+    if (nos[no].balanceamento == 0)
       break;
-    case 6:
-      printf("Percurso pós-ordem: ");
-      posOrdem(raiz);
-      printf("\n");
+    if (nos[no].balanceamento > 1 || nos[no].balanceamento < -1)
+    {
+      religarCompacta(arvore, caminho, lados, topo - 1, balancearNoCompacto(nos, no));
       break;
-    case 7:
-      printf("\nEstrutura da árvore AVL:\n");
-      exibirArvore(raiz, 0);
+    }
+  }
+  return 1;
+}
+
+// Função para remover uma chave da árvore compacta
+// Descrição:
+// Mesmo percurso de removerIterativo(): um nó com dois filhos é substituído pelo sucessor
+// in-order, que é religado no lugar dele (nenhuma chave é copiada), e a posição liberada
+// vai para a lista de livres.
+
+// Lógica:
+
+// Na volta, o fator de cada nó diminui (a remoção foi à esquerda) ou aumenta (à direita):
+//  - se ficou 1 ou -1, o nó estava equilibrado e a altura não mudou: a volta termina;
+//  - se ficou 0, a altura diminuiu e a volta continua;
+//  - se ficou 2 ou -2, rebalanceia; se o filho do lado mais alto estava equilibrado, a rotação
+//    mantém a altura e a volta termina, senão a altura diminuiu e a volta continua.
+// Retorna 1 se removeu, 0 se a chave não existia.
+
+int removerCompacta(struct ArvoreCompacta *arvore, int chave)
+{
+  struct NoCompacto *nos = arvore->nos;
+  uint32_t caminho[MAX_ALTURA_AVL];
+  int lados[MAX_ALTURA_AVL];
+  int topo = 0;
+  uint32_t atual = arvore->raiz;
+
+  while (atual != 0 && nos[atual].chave != chave)
+  {
+    caminho[topo] = atual;
+    lados[topo] = chave < nos[atual].chave ? 0 : 1;
+    atual = lados[topo] == 0 ? nos[atual].esquerda : nos[atual].direita;
+    topo++;
+  }
+  if (atual == 0)
+    return 0;
+
+  if (nos[atual].esquerda != 0 && nos[atual].direita != 0)
+  {
+    int indiceAlvo = topo;
+    caminho[topo] = atual;
+    lados[topo] = 1;
+    topo++;
+    uint32_t sucessor = nos[atual].direita;
+    while (nos[sucessor].esquerda != 0)
+    {
+      caminho[topo] = sucessor;
+      lados[topo] = 0;
+      topo++;
+      sucessor = nos[sucessor].esquerda;
+    }
+    religarCompacta(arvore, caminho, lados, topo - 1, nos[sucessor].direita);
+
+    // O sucessor assume o lugar, os filhos e o fator do nó removido; no caminho, a entrada
+    // do nó removido passa a ser a do sucessor
+    nos[sucessor].esquerda = nos[atual].esquerda;
+    nos[sucessor].direita = nos[atual].direita;
+    nos[sucessor].balanceamento = nos[atual].balanceamento;
+    religarCompacta(arvore, caminho, lados, indiceAlvo - 1, sucessor);
+    caminho[indiceAlvo] = sucessor;
+  }
+  else
+  {
+    religarCompacta(arvore, caminho, lados, topo - 1, nos[atual].esquerda != 0 ? nos[atual].esquerda : nos[atual].direita);
+  }
+  nos[atual].esquerda = arvore->livre;
+  arvore->livre = atual;
+  arvore->numChaves--;
+
+  while (topo > 0)
+  {
+    uint32_t no = caminho[--topo];
+    nos[no].balanceamento += lados[topo] == 0 ? -1 : 1;
+    if (nos[no].balanceamento == 1 || nos[no].balanceamento == -1)
       break;
-    case 8:
-      printf("Saindo...\n");
+    if (nos[no].balanceamento != 0)
+    {
+      uint32_t irmao = nos[no].balanceamento > 0 ? nos[no].esquerda : nos[no].direita;
+      int balanceamentoIrmao = nos[irmao].balanceamento;
+      religarCompacta(arvore, caminho, lados, topo - 1, balancearNoCompacto(nos, no));
+      if (balanceamentoIrmao == 0)
+        break;
+    }
+  }
+  return 1;
+}
+
+// Percurso em ordem da árvore compacta, sem recursão
+void emOrdemCompacta(struct ArvoreCompacta *arvore)
+{
+  uint32_t pilha[MAX_ALTURA_AVL];
+  int topo = 0;
+  uint32_t atual = arvore->raiz;
+  while (atual != 0 || topo > 0)
+  {
+    while (atual != 0)
+    {
+      pilha[topo++] = atual;
+      atual = arvore->nos[atual].esquerda;
+    }
+    atual = pilha[--topo];
+    printf("%d ", arvore->nos[atual].chave);
+    atual = arvore->nos[atual].direita;
+  }
+}
+
+// Gravação segura de arquivo
+// Descrição:
+// O arquivo é escrito primeiro em "<nome>.tmp", no mesmo diretório, e só depois renomeado por cima
+// do original. Assim um arquivo que está mapeado (árvore compacta aberta pela opção 11, ou a
+// própria árvore sendo gravada no arquivo de onde veio) não é truncado enquanto está em uso: o
+// mapeamento continua apontando para o arquivo antigo, que só some quando for desmapeado.
+// Uma gravação que falha no meio também não estraga o arquivo que já existia.
+
+FILE *abrirArquivoTemporario(const char *nomeArquivo, char *nomeTemporario, size_t tamanho)
+{
+  if ((size_t)snprintf(nomeTemporario, tamanho, "%s.tmp", nomeArquivo) >= tamanho)
+    return NULL;
+  return fopen(nomeTemporario, "wb");
+}
+
+// Fecha o temporário e, se tudo foi gravado (ok), coloca-o no lugar do arquivo final.
+// Retorna 1 se o arquivo final foi substituído.
+int concluirArquivoTemporario(FILE *arquivo, const char *nomeTemporario, const char *nomeArquivo, int ok)
+{
+  if (fclose(arquivo) != 0)
+    ok = 0;
+#ifdef _WIN32
+  // No Windows rename() não substitui um arquivo existente (lá o arquivo nunca fica mapeado)
+  if (ok)
+    remove(nomeArquivo);
+#endif
+  if (ok && rename(nomeTemporario, nomeArquivo) != 0)
+    ok = 0;
+  if (!ok)
+    remove(nomeTemporario);
+  return ok;
+}
+
+// Função para gravar a árvore compacta em arquivo
+// O vetor de nós vai como está, logo depois do cabeçalho. Retorna 1 se gravou.
+int salvarArvoreCompacta(struct ArvoreCompacta *arvore, const char *nomeArquivo)
+{
+  char nomeTemporario[4096];
+  FILE *arquivo = abrirArquivoTemporario(nomeArquivo, nomeTemporario, sizeof(nomeTemporario));
+  if (arquivo == NULL)
+    return 0;
+
+  struct CabecalhoArvoreCompacta cabecalho;
+  memset(&cabecalho, 0, sizeof(cabecalho));
+  memcpy(cabecalho.magica, MAGICA_ARVORE_COMPACTA, 8);
+  cabecalho.quantidade = arvore->quantidade;
+  cabecalho.raiz = arvore->raiz;
+  cabecalho.livre = arvore->livre;
+  cabecalho.numChaves = arvore->numChaves;
+
+  int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+           fwrite(arvore->nos, sizeof(struct NoCompacto), arvore->quantidade, arquivo) == arvore->quantidade;
+  return concluirArquivoTemporario(arquivo, nomeTemporario, nomeArquivo, ok);
+}
+
+// Confere a subárvore compacta 'no' vinda de arquivo e retorna a altura dela (-1 se for inválida)
+// Cada índice precisa estar dentro do vetor e aparecer uma só vez (sem ciclos nem nós compartilhados),
+// a profundidade não pode passar de MAX_ALTURA_AVL (o tamanho das pilhas de inserção e remoção),
+// as chaves precisam respeitar os limites (menor, maior) herdados dos ancestrais e o fator guardado
+// em cada nó precisa ser a diferença real entre as alturas das subárvores.
+int validarSubarvoreCompacta(struct ArvoreCompacta *arvore, uint32_t no, int profundidade, long long menor,
+                             long long maior, unsigned char *visitado, uint32_t *contador)
+{
+  if (no == 0)
+    return 0;
+  if (no >= arvore->quantidade || visitado[no] || profundidade >= MAX_ALTURA_AVL)
+    return -1;
+  visitado[no] = 1;
+  (*contador)++;
+
+  struct NoCompacto *n = &arvore->nos[no];
+  if (n->chave <= menor || n->chave >= maior || n->balanceamento < -1 || n->balanceamento > 1)
+    return -1;
+  int alturaEsquerda = validarSubarvoreCompacta(arvore, n->esquerda, profundidade + 1, menor, n->chave, visitado, contador);
+  int alturaDireita = validarSubarvoreCompacta(arvore, n->direita, profundidade + 1, n->chave, maior, visitado, contador);
+  if (alturaEsquerda < 0 || alturaDireita < 0 || alturaEsquerda - alturaDireita != n->balanceamento)
+    return -1;
+  return 1 + max(alturaEsquerda, alturaDireita);
+}
+
+// Confere uma árvore compacta inteira vinda de arquivo, em O(n)
+// Além da árvore, a lista de livres só pode ter índices dentro do vetor que não estão na árvore
+// (e sem ciclos), e árvore + livres + a posição 0 reservada precisam cobrir o vetor todo.
+// Retorna 1 se a árvore é válida.
+int validarArvoreCompacta(struct ArvoreCompacta *arvore)
+{
+  unsigned char *visitado = (unsigned char *)calloc(arvore->quantidade, 1);
+  uint32_t nosNaArvore = 0, livres = 0;
+  int ok = 1;
+
+  visitado[0] = 1;
+  if (validarSubarvoreCompacta(arvore, arvore->raiz, 0, (long long)INT_MIN - 1, (long long)INT_MAX + 1, visitado,
+                               &nosNaArvore) < 0 ||
+      nosNaArvore != arvore->numChaves)
+    ok = 0;
+  for (uint32_t livre = arvore->livre; ok && livre != 0; livre = arvore->nos[livre].esquerda)
+  {
+    if (livre >= arvore->quantidade || visitado[livre])
+      ok = 0;
+    else
+    {
+      visitado[livre] = 1;
+      livres++;
+    }
+  }
+  if (ok && (uint64_t)nosNaArvore + livres + 1 != arvore->quantidade)
+    ok = 0;
+  free(visitado);
+  return ok;
+}
+
+// Função para carregar uma árvore compacta de arquivo
+// Descrição:
+// Com mmap, o vetor de nós aponta direto para as páginas do arquivo: nada é lido nem reconstruído,
+// e as páginas só são carregadas quando a busca passa por elas. O mapeamento é privado, então a
+// árvore carregada aceita inserções e remoções sem alterar o arquivo (a primeira inserção que
+// precisar crescer o vetor copia os nós para a memória). No Windows o arquivo é lido para a memória.
+// Como os índices do arquivo são usados direto no vetor, a árvore inteira é conferida antes de ser
+// usada (validarArvoreCompacta(), uma passada por todos os nós).
+// Retorna NULL se o arquivo não existe ou não é uma árvore compacta válida.
+
+struct ArvoreCompacta *carregarArvoreCompacta(const char *nomeArquivo)
+{
+  unsigned char *dados = NULL;
+  size_t tamanho = 0;
+  struct ArvoreCompacta *arvore = (struct ArvoreCompacta *)calloc(1, sizeof(struct ArvoreCompacta));
+
+#ifdef _WIN32
+  FILE *arquivo = fopen(nomeArquivo, "rb");
+  if (arquivo == NULL)
+  {
+    free(arvore);
+    return NULL;
+  }
+  fseek(arquivo, 0, SEEK_END);
+  tamanho = ftell(arquivo);
+  fseek(arquivo, 0, SEEK_SET);
+  dados = (unsigned char *)malloc(tamanho);
+  if (fread(dados, 1, tamanho, arquivo) != tamanho)
+    tamanho = 0;
+  fclose(arquivo);
+#else
+  int descritor = open(nomeArquivo, O_RDONLY);
+  struct stat informacoes;
+  if (descritor < 0 || fstat(descritor, &informacoes) != 0 || informacoes.st_size == 0)
+  {
+    if (descritor >= 0)
+      close(descritor);
+    free(arvore);
+    return NULL;
+  }
+  tamanho = informacoes.st_size;
+  dados = (unsigned char *)mmap(NULL, tamanho, PROT_READ | PROT_WRITE, MAP_PRIVATE, descritor, 0);
+  close(descritor);
+  if (dados == MAP_FAILED)
+  {
+    free(arvore);
+    return NULL;
+  }
+#endif
+  arvore->mapeamento = dados;
+  arvore->tamanhoMapeamento = tamanho;
+
+  struct CabecalhoArvoreCompacta *cabecalho = (struct CabecalhoArvoreCompacta *)dados;
+  if (tamanho < sizeof(struct CabecalhoArvoreCompacta) || memcmp(cabecalho->magica, MAGICA_ARVORE_COMPACTA, 8) != 0 ||
+      cabecalho->quantidade == 0 ||
+      tamanho != sizeof(struct CabecalhoArvoreCompacta) + (size_t)cabecalho->quantidade * sizeof(struct NoCompacto) ||
+      cabecalho->raiz >= cabecalho->quantidade || cabecalho->livre >= cabecalho->quantidade)
+  {
+    liberarArvoreCompacta(arvore);
+    return NULL;
+  }
+
+  arvore->nos = (struct NoCompacto *)(dados + sizeof(struct CabecalhoArvoreCompacta));
+  arvore->quantidade = cabecalho->quantidade;
+  arvore->capacidade = cabecalho->quantidade;
+  arvore->raiz = cabecalho->raiz;
+  arvore->livre = cabecalho->livre;
+  arvore->numChaves = cabecalho->numChaves;
+  if (!validarArvoreCompacta(arvore))
+  {
+    liberarArvoreCompacta(arvore);
+    return NULL;
+  }
+  return arvore;
+}
+
+// Copia as chaves de uma árvore de ponteiros para a árvore compacta (em pré-ordem)
+void copiarParaCompacta(struct No *raiz, struct ArvoreCompacta *arvore)
+{
+  if (raiz == NULL)
+    return;
+  inserirCompacta(arvore, raiz->chave);
+  copiarParaCompacta(raiz->esquerda, arvore);
+  copiarParaCompacta(raiz->direita, arvore);
+}
+
+// Copia as chaves da subárvore compacta 'no' para uma árvore de ponteiros (em pré-ordem)
+void copiarDeCompacta(struct ArvoreCompacta *arvore, uint32_t no, struct No **raizPtr)
+{
+  if (no == 0)
+    return;
+  inserirIterativo(raizPtr, arvore->nos[no].chave);
+  copiarDeCompacta(arvore, arvore->nos[no].esquerda, raizPtr);
+  copiarDeCompacta(arvore, arvore->nos[no].direita, raizPtr);
+}
+
+// ---------------------------------------------------------------------------
+// Mapa AVL genérico: chave -> valor, gerado por macro para cada par de tipos.
+// DEFINIR_MAPA_AVL(Nome, TipoChave, TipoValor, COMPARA, COPIA_CHAVE, LIBERA_CHAVE) cria
+// struct Nome (o mapa), struct NomeNo e as funções NomeInserir, NomeBuscar, NomeRemover,
+// NomePercorrer e NomeLiberar. COMPARA(a, b) devolve <0, 0 ou >0 e é expandido dentro das
+// funções, então para chaves inteiras a comparação fica inline, sem void* nem ponteiro para função.
+// COPIA_CHAVE e LIBERA_CHAVE dizem como o mapa guarda a chave (uma cópia de texto, por exemplo).
+// Inserção e remoção seguem inserirIterativo() e removerIterativo(): pilha de ligações,
+// religação do sucessor e volta interrompida assim que a altura de uma subárvore não muda.
+// ---------------------------------------------------------------------------
+
+#define COMPARA_INTEIRO(a, b) (((a) > (b)) - ((a) < (b)))
+#define COMPARA_TEXTO(a, b) strcmp((a), (b))
+#define CHAVE_SEM_COPIA(c) (c)
+#define CHAVE_SEM_LIBERAR(c) ((void)0)
+#define CHAVE_COPIA_TEXTO(c) duplicarTexto(c)
+#define CHAVE_LIBERA_TEXTO(c) free((char *)(c))
+
+// strdup() não faz parte do C padrão
+char *duplicarTexto(const char *texto)
+{
+  size_t tamanho = strlen(texto) + 1;
+  char *copia = (char *)malloc(tamanho);
+  memcpy(copia, texto, tamanho);
+  return copia;
+}
+
+#define DEFINIR_MAPA_AVL(Nome, TipoChave, TipoValor, COMPARA, COPIA_CHAVE, LIBERA_CHAVE)               \
+  struct Nome##No                                                                                       \
+  {                                                                                                     \
+    TipoChave chave;                                                                                    \
+    TipoValor valor;                                                                                    \
+    struct Nome##No *esquerda;                                                                          \
+    struct Nome##No *direita;                                                                           \
+    int altura;                                                                                         \
+  };                                                                                                    \
+                                                                                                        \
+  struct Nome                                                                                           \
+  {                                                                                                     \
+    struct Nome##No *raiz;                                                                              \
+    size_t tamanho;                                                                                     \
+  };                                                                                                    \
+                                                                                                        \
+  static int Nome##Altura(struct Nome##No *n) { return n == NULL ? 0 : n->altura; }                     \
+                                                                                                        \
+  static void Nome##AtualizarAltura(struct Nome##No *n)                                                 \
+  {                                                                                                     \
+    n->altura = 1 + max(Nome##Altura(n->esquerda), Nome##Altura(n->direita));                           \
+  }                                                                                                     \
+                                                                                                        \
+  static struct Nome##No *Nome##RotacaoDireita(struct Nome##No *y)                                      \
+  {                                                                                                     \
+    struct Nome##No *x = y->esquerda;                                                                   \
+    y->esquerda = x->direita;                                                                           \
+    x->direita = y;                                                                                     \
+    Nome##AtualizarAltura(y);                                                                           \
+    Nome##AtualizarAltura(x);                                                                           \
+    return x;                                                                                           \
+  }                                                                                                     \
+                                                                                                        \
+  static struct Nome##No *Nome##RotacaoEsquerda(struct Nome##No *x)                                     \
+  {                                                                                                     \
+    struct Nome##No *y = x->direita;                                                                    \
+    x->direita = y->esquerda;                                                                           \
+    y->esquerda = x;                                                                                    \
+    Nome##AtualizarAltura(x);                                                                           \
+    Nome##AtualizarAltura(y);                                                                           \
+    return y;                                                                                           \
+  }                                                                                                     \
+                                                                                                        \
+  /* Mesmo papel de balancearNo(): atualiza a altura e, se preciso, faz a rotação simples ou dupla */   \
+  static struct Nome##No *Nome##Balancear(struct Nome##No *no)                                          \
+  {                                                                                                     \
+    Nome##AtualizarAltura(no);                                                                          \
+    int balanceamento = Nome##Altura(no->esquerda) - Nome##Altura(no->direita);                         \
+    if (balanceamento > 1)                                                                              \
+    {                                                                                                   \
+      if (Nome##Altura(no->esquerda->esquerda) < Nome##Altura(no->esquerda->direita))                   \
+        no->esquerda = Nome##RotacaoEsquerda(no->esquerda);                                             \
+      return Nome##RotacaoDireita(no);                                                                  \
+    }                                                                                                   \
+    if (balanceamento < -1)                                                                             \
+    {                                                                                                   \
+      if (Nome##Altura(no->direita->direita) < Nome##Altura(no->direita->esquerda))                     \
+        no->direita = Nome##RotacaoDireita(no->direita);                                                \
+      return Nome##RotacaoEsquerda(no);                                                                 \
+    }                                                                                                   \
+    return no;                                                                                          \
+  }                                                                                                     \
+                                                                                                        \
+  /* Retorna o endereço do valor associado à chave, ou NULL */                                          \
+  static TipoValor *Nome##Buscar(struct Nome *mapa, TipoChave chave)                                    \
+  {                                                                                                     \
+    struct Nome##No *atual = mapa->raiz;                                                                \
+    while (atual != NULL)                                                                               \
+    {                                                                                                   \
+      int comparacao = COMPARA(chave, atual->chave);                                                    \
+      if (comparacao == 0)                                                                              \
+        return &atual->valor;                                                                           \
+      atual = comparacao < 0 ? atual->esquerda : atual->direita;                                        \
+    }                                                                                                   \
+    return NULL;                                                                                        \
+  }                                                                                                     \
+                                                                                                        \
+  /* Associa o valor à chave. Retorna 1 se a chave era nova, 0 se só o valor foi trocado */             \
+  static int Nome##Inserir(struct Nome *mapa, TipoChave chave, TipoValor valor)                         \
+  {                                                                                                     \
+    struct Nome##No **caminho[MAX_ALTURA_AVL];                                                          \
+    int topo = 0;                                                                                       \
+    struct Nome##No **link = &mapa->raiz;                                                               \
+    while (*link != NULL)                                                                               \
+    {                                                                                                   \
+      int comparacao = COMPARA(chave, (*link)->chave);                                                  \
+      if (comparacao == 0)                                                                              \
+      {                                                                                                 \
+        (*link)->valor = valor;                                                                         \
+        return 0;                                                                                       \
+      }                                                                                                 \
+      caminho[topo++] = link;                                                                           \
+      link = comparacao < 0 ? &(*link)->esquerda : &(*link)->direita;                                   \
+    }                                                                                                   \
+    struct Nome##No *novo = (struct Nome##No *)malloc(sizeof(struct Nome##No));                         \
+    novo->chave = COPIA_CHAVE(chave);                                                                   \
+    novo->valor = valor;                                                                                \
+    novo->esquerda = NULL;                                                                              \
+    novo->direita = NULL;                                                                               \
+    novo->altura = 1;                                                                                   \
+    *link = novo;                                                                                       \
+    mapa->tamanho++;                                                                                    \
+                                                                                                        \
+    while (topo > 0)                                                                                    \
+    {                                                                                                   \
+      link = caminho[--topo];                                                                           \
+      int alturaAntiga = (*link)->altura;                                                               \
+      *link = Nome##Balancear(*link);                                                                   \
+      if ((*link)->altura == alturaAntiga)                                                              \
+        break;                                                                                          \
+    }                                                                                                   \
+    return 1;                                                                                           \
+  }                                                                                                     \
+                                                                                                        \
+  /* Remove a chave; se 'valorRemovido' não for NULL, recebe o valor que estava associado a ela.        \
+     Retorna 1 se removeu, 0 se a chave não existia */                                                  \
+  static int Nome##Remover(struct Nome *mapa, TipoChave chave, TipoValor *valorRemovido)                \
+  {                                                                                                     \
+    struct Nome##No **caminho[MAX_ALTURA_AVL];                                                          \
+    int topo = 0;                                                                                       \
+    struct Nome##No **link = &mapa->raiz;                                                               \
+    int comparacao = 0;                                                                                 \
+    while (*link != NULL && (comparacao = COMPARA(chave, (*link)->chave)) != 0)                         \
+    {                                                                                                   \
+      caminho[topo++] = link;                                                                           \
+      link = comparacao < 0 ? &(*link)->esquerda : &(*link)->direita;                                   \
+    }                                                                                                   \
+    if (*link == NULL)                                                                                  \
+      return 0;                                                                                         \
+                                                                                                        \
+    struct Nome##No *no = *link;                                                                        \
+    if (no->esquerda != NULL && no->direita != NULL)                                                    \
+    {                                                                                                   \
+      int indiceAlvo = topo;                                                                            \
+      caminho[topo++] = link;                                                                           \
+      struct Nome##No **linkSucessor = &no->direita;                                                    \
+      while ((*linkSucessor)->esquerda != NULL)                                                         \
+      {                                                                                                 \
+        caminho[topo++] = linkSucessor;                                                                 \
+        linkSucessor = &(*linkSucessor)->esquerda;                                                      \
+      }                                                                                                 \
+      struct Nome##No *sucessor = *linkSucessor;                                                        \
+      *linkSucessor = sucessor->direita;                                                                \
+      sucessor->esquerda = no->esquerda;                                                                \
+      sucessor->direita = no->direita;                                                                  \
+      sucessor->altura = no->altura;                                                                    \
+      *link = sucessor;                                                                                 \
+      if (indiceAlvo + 1 < topo)                                                                        \
+        caminho[indiceAlvo + 1] = &sucessor->direita;                                                   \
+    }                                                                                                   \
+    else                                                                                                \
+    {                                                                                                   \
+      *link = no->esquerda != NULL ? no->esquerda : no->direita;                                        \
+    }                                                                                                   \
+    if (valorRemovido != NULL)                                                                          \
+      *valorRemovido = no->valor;                                                                       \
+    LIBERA_CHAVE(no->chave);                                                                            \
+    free(no);                                                                                           \
+    mapa->tamanho--;                                                                                    \
+                                                                                                        \
+    while (topo > 0)                                                                                    \
+    {                                                                                                   \
+      link = caminho[--topo];                                                                           \
+      int alturaAntiga = (*link)->altura;                                                               \
+      *link = Nome##Balancear(*link);                                                                   \
+      if ((*link)->altura == alturaAntiga)                                                              \
+        break;                                                                                          \
+    }                                                                                                   \
+    return 1;                                                                                           \
+  }                                                                                                     \
+                                                                                                        \
+  /* Visita os pares em ordem crescente de chave, sem recursão */                                       \
+  static void Nome##Percorrer(struct Nome *mapa, void (*visita)(TipoChave, TipoValor *, void *),        \
+                              void *contexto)                                                           \
+  {                                                                                                     \
+    struct Nome##No *pilha[MAX_ALTURA_AVL];                                                             \
+    int topo = 0;                                                                                       \
+    struct Nome##No *atual = mapa->raiz;                                                                \
+    while (atual != NULL || topo > 0)                                                                   \
+    {                                                                                                   \
+      while (atual != NULL)                                                                             \
+      {                                                                                                 \
+        pilha[topo++] = atual;                                                                          \
+        atual = atual->esquerda;                                                                        \
+      }                                                                                                 \
+      atual = pilha[--topo];                                                                            \
+      visita(atual->chave, &atual->valor, contexto);                                                    \
+      atual = atual->direita;                                                                           \
+    }                                                                                                   \
+  }                                                                                                     \
+                                                                                                        \
+  static void Nome##LiberarNos(struct Nome##No *no)                                                     \
+  {                                                                                                     \
+    if (no == NULL)                                                                                     \
+      return;                                                                                           \
+    Nome##LiberarNos(no->esquerda);                                                                     \
+    Nome##LiberarNos(no->direita);                                                                      \
+    LIBERA_CHAVE(no->chave);                                                                            \
+    free(no);                                                                                           \
+  }                                                                                                     \
+                                                                                                        \
+  static void Nome##Liberar(struct Nome *mapa)                                                          \
+  {                                                                                                     \
+    Nome##LiberarNos(mapa->raiz);                                                                       \
+    mapa->raiz = NULL;                                                                                  \
+    mapa->tamanho = 0;                                                                                  \
+  }
+
+// Registro de exemplo guardado nos mapas
+struct Registro
+{
+  char nome[32];
+  double saldo;
+};
+
+// Mapa de IDs de 64 bits para registros e mapa de textos para registros
+DEFINIR_MAPA_AVL(MapaId, int64_t, struct Registro, COMPARA_INTEIRO, CHAVE_SEM_COPIA, CHAVE_SEM_LIBERAR)
+DEFINIR_MAPA_AVL(MapaTexto, const char *, struct Registro, COMPARA_TEXTO, CHAVE_COPIA_TEXTO, CHAVE_LIBERA_TEXTO)
+
+void imprimirRegistroId(int64_t chave, struct Registro *registro, void *contexto)
+{
+  (void)contexto;
+  printf("  %" PRId64 " -> %s (%.2f)\n", chave, registro->nome, registro->saldo);
+}
+
+void imprimirRegistroTexto(const char *chave, struct Registro *registro, void *contexto)
+{
+  (void)contexto;
+  printf("  %s -> %s (%.2f)\n", chave, registro->nome, registro->saldo);
+}
+
+// Demonstração dos dois mapas: os registros são cadastrados por ID e indexados também pelo nome
+void demonstrarMapas()
+{
+  struct MapaId porId = {NULL, 0};
+  struct MapaTexto porNome = {NULL, 0};
+  const char *nomes[] = {"Carla", "Bruno", "Ana", "Eduardo", "Daniela"};
+  int64_t ids[] = {9000000005LL, 42, 9000000001LL, -7, 1234567890123LL};
+
+  for (int i = 0; i < 5; i++)
+  {
+    struct Registro registro;
+    snprintf(registro.nome, sizeof(registro.nome), "%s", nomes[i]);
+    registro.saldo = 100.0 * (i + 1);
+    MapaIdInserir(&porId, ids[i], registro);
+    MapaTextoInserir(&porNome, registro.nome, registro);
+  }
+
+  printf("Por ID (%zu registros):\n", porId.tamanho);
+  MapaIdPercorrer(&porId, imprimirRegistroId, NULL);
+  printf("Por nome (%zu registros):\n", porNome.tamanho);
+  MapaTextoPercorrer(&porNome, imprimirRegistroTexto, NULL);
+
+  struct Registro *encontrado = MapaIdBuscar(&porId, 42);
+  printf("Busca do ID 42: %s\n", encontrado != NULL ? encontrado->nome : "nao encontrado");
+  encontrado = MapaTextoBuscar(&porNome, "Daniela");
+  printf("Busca de \"Daniela\": saldo %.2f\n", encontrado != NULL ? encontrado->saldo : 0.0);
+
+  struct Registro removido;
+  if (MapaIdRemover(&porId, -7, &removido))
+  {
+    MapaTextoRemover(&porNome, removido.nome, NULL);
+    printf("Removido o ID -7 (%s); restam %zu / %zu registros.\n", removido.nome, porId.tamanho, porNome.tamanho);
+  }
+
+  MapaIdLiberar(&porId);
+  MapaTextoLiberar(&porNome);
+}
+
+// ---------------------------------------------------------------------------
+// Construção em lote a partir de chaves ordenadas
+// ---------------------------------------------------------------------------
+
+// Função para construir uma árvore AVL a partir de chaves em ordem estritamente crescente
+// Descrição:
+// Monta a árvore diretamente, em O(n), sem nenhuma rotação: inserir chaves ordenadas uma a uma
+// é o pior caso do rebalanceamento (toda inserção cai no mesmo lado).
+
+// Lógica:
+
+// A chave do meio vira a raiz, a metade da esquerda vira a subárvore esquerda e a da direita
+// a subárvore direita. As duas metades diferem em no máximo uma chave, então as alturas das
+// subárvores diferem em no máximo 1 e a árvore já sai balanceada, com as alturas preenchidas.
+
+struct No *construirDeOrdenado(int *chaves, size_t n)
+{
+  if (n == 0)
+    return NULL;
+  size_t meio = n / 2;
+  struct No *no = criarNo(chaves[meio]);
+  no->esquerda = construirDeOrdenado(chaves, meio);
+  no->direita = construirDeOrdenado(chaves + meio + 1, n - meio - 1);
+  no->altura = 1 + max(obterAltura(no->esquerda), obterAltura(no->direita));
+  atualizarTamanho(no);
+  return no;
+}
+
+// Função para contar os nós da árvore
+size_t contarNos(struct No *raiz)
+{
+  if (raiz == NULL)
+    return 0;
+  return 1 + contarNos(raiz->esquerda) + contarNos(raiz->direita);
+}
+
+// Copia as chaves da árvore em ordem crescente para 'destino'. Retorna quantas foram copiadas.
+size_t copiarEmOrdem(struct No *raiz, int *destino)
+{
+  struct No *pilha[MAX_ALTURA_AVL];
+  int topo = 0;
+  size_t n = 0;
+  while (raiz != NULL || topo > 0)
+  {
+    while (raiz != NULL)
+    {
+      pilha[topo++] = raiz;
+      raiz = raiz->esquerda;
+    }
+    raiz = pilha[--topo];
+    destino[n++] = raiz->chave;
+    raiz = raiz->direita;
+  }
+  return n;
+}
+
+// Função para carregar chaves em lote de um arquivo (ou da entrada padrão)
+// Descrição:
+// Lê todos os inteiros da entrada e verifica se vieram em ordem crescente.
+
+// Lógica:
+
+// Entrada ordenada: as chaves da árvore atual são copiadas em ordem, intercaladas com as novas
+// (descartando repetidas) e a árvore é reconstruída com construirDeOrdenado(), em O(n + m).
+// Entrada fora de ordem: as chaves são inseridas uma a uma com inserirIterativo().
+
+void carregarEmLote(struct No **raizPtr, FILE *entrada)
+{
+  size_t capacidade = 1024, n = 0;
+  int *chaves = (int *)malloc(capacidade * sizeof(int));
+  int chave;
+  int ordenada = 1;
+
+  clock_t inicio = clock();
+  while (fscanf(entrada, "%d", &chave) == 1)
+  {
+    if (n == capacidade)
+    {
+      capacidade *= 2;
+      chaves = (int *)realloc(chaves, capacidade * sizeof(int));
+    }
+    if (n > 0 && chave < chaves[n - 1])
+      ordenada = 0;
+    chaves[n++] = chave;
+  }
+
+  if (ordenada)
+  {
+    size_t existentes = contarNos(*raizPtr);
+    int *atuais = (int *)malloc((existentes + 1) * sizeof(int));
+    copiarEmOrdem(*raizPtr, atuais);
+
+    int *todas = (int *)malloc((existentes + n + 1) * sizeof(int));
+    size_t i = 0, j = 0, total = 0;
+    while (i < existentes || j < n)
+    {
+      int proxima;
+      if (j == n || (i < existentes && atuais[i] <= chaves[j]))
+        proxima = atuais[i++];
+      else
+        proxima = chaves[j++];
+      if (total == 0 || todas[total - 1] != proxima)
+        todas[total++] = proxima;
+    }
+
+    liberarArvore(*raizPtr);
+    *raizPtr = construirDeOrdenado(todas, total);
+    free(atuais);
+    free(todas);
+  }
+  else
+  {
+    for (size_t i = 0; i < n; i++)
+      inserirIterativo(raizPtr, chaves[i]);
+  }
+  free(chaves);
+
+  printf("%zu chaves lidas (%s), %zu na arvore, altura %d, %.3f s\n", n,
+         ordenada ? "ordenadas: construcao direta" : "fora de ordem: insercao uma a uma",
+         contarNos(*raizPtr), obterAltura(*raizPtr), (double)(clock() - inicio) / CLOCKS_PER_SEC);
+}
+
+// ---------------------------------------------------------------------------
+// Consultas ordenadas: iterador, lowerBound/upperBound, posição e seleção
+// ---------------------------------------------------------------------------
+
+// Iterador em ordem, nos dois sentidos, sem recursão e sem ponteiro para o pai
+// A pilha guarda o caminho da raiz até o nó atual (pilha[topo - 1]); pilha vazia = fim.
+// Avançar ou voltar custa O(1) amortizado, então percorrer k chaves a partir de uma posição
+// encontrada em O(log n) custa O(log n + k).
+struct IteradorAVL
+{
+  struct No *pilha[MAX_ALTURA_AVL];
+  int topo;
+};
+
+int iteradorValido(struct IteradorAVL *it) { return it->topo > 0; }
+
+int iteradorChave(struct IteradorAVL *it) { return it->pilha[it->topo - 1]->chave; }
+
+// Empilha o caminho de 'no' até o menor (ou o maior) nó da sua subárvore
+void descerExtremo(struct IteradorAVL *it, struct No *no, int paraDireita)
+{
+  while (no != NULL)
+  {
+    it->pilha[it->topo++] = no;
+    no = paraDireita ? no->direita : no->esquerda;
+  }
+}
+
+// Posiciona no menor (ou no maior) nó da árvore
+void iteradorInicio(struct IteradorAVL *it, struct No *raiz)
+{
+  it->topo = 0;
+  descerExtremo(it, raiz, 0);
+}
+
+void iteradorUltimo(struct IteradorAVL *it, struct No *raiz)
+{
+  it->topo = 0;
+  descerExtremo(it, raiz, 1);
+}
+
+// Função para avançar o iterador para a próxima chave
+// Lógica:
+// Se o nó atual tem subárvore direita, o próximo é o menor nó dela. Senão, sobe enquanto o nó
+// de onde veio for filho direito do nó de cima; o primeiro ancestral alcançado pela esquerda é o próximo.
+void iteradorProximo(struct IteradorAVL *it)
+{
+  struct No *atual = it->pilha[it->topo - 1];
+  if (atual->direita != NULL)
+  {
+    descerExtremo(it, atual->direita, 0);
+    return;
+  }
+  it->topo--;
+  while (it->topo > 0 && it->pilha[it->topo - 1]->direita == atual)
+    atual = it->pilha[--it->topo];
+}
+
+// Função para voltar o iterador para a chave anterior (simétrica a iteradorProximo)
+void iteradorAnterior(struct IteradorAVL *it)
+{
+  struct No *atual = it->pilha[it->topo - 1];
+  if (atual->esquerda != NULL)
+  {
+    descerExtremo(it, atual->esquerda, 1);
+    return;
+  }
+  it->topo--;
+  while (it->topo > 0 && it->pilha[it->topo - 1]->esquerda == atual)
+    atual = it->pilha[--it->topo];
+}
+
+// Função para posicionar o iterador na primeira chave >= chave (lowerBound)
+// ou, com 'estrito', na primeira chave > chave (upperBound)
+// Lógica:
+// Desce como numa busca, empilhando o caminho. Cada nó que satisfaz a condição é candidato e a
+// descida continua pela esquerda atrás de um menor; senão continua pela direita. O melhor
+// candidato está no caminho, então basta cortar a pilha na profundidade dele.
+void posicionarLimite(struct IteradorAVL *it, struct No *raiz, int chave, int estrito)
+{
+  int profundidadeCandidato = 0;
+  it->topo = 0;
+  while (raiz != NULL)
+  {
+    it->pilha[it->topo++] = raiz;
+    if (raiz->chave > chave || (!estrito && raiz->chave == chave))
+    {
+      profundidadeCandidato = it->topo;
+      raiz = raiz->esquerda;
+    }
+    else
+    {
+      raiz = raiz->direita;
+    }
+  }
+  it->topo = profundidadeCandidato;
+}
+
+void lowerBound(struct IteradorAVL *it, struct No *raiz, int chave) { posicionarLimite(it, raiz, chave, 0); }
+
+void upperBound(struct IteradorAVL *it, struct No *raiz, int chave) { posicionarLimite(it, raiz, chave, 1); }
+
+#ifndef AVL_SEM_TAMANHO
+// Função para obter a posição (rank) de uma chave: quantas chaves da árvore são menores que ela
+// Cada vez que a descida vai para a direita, o nó e a subárvore esquerda dele ficam para trás.
+int posicaoChave(struct No *raiz, int chave)
+{
+  int menores = 0;
+  while (raiz != NULL)
+  {
+    if (chave <= raiz->chave)
+    {
+      raiz = raiz->esquerda;
+    }
+    else
+    {
+      menores += obterTamanho(raiz->esquerda) + 1;
+      raiz = raiz->direita;
+    }
+  }
+  return menores;
+}
+
+// Função para contar as chaves no intervalo [inicio, fim] em O(log n)
+int contarIntervalo(struct No *raiz, int inicio, int fim)
+{
+  if (inicio > fim)
+    return 0;
+  int ateFim = fim == INT_MAX ? obterTamanho(raiz) : posicaoChave(raiz, fim + 1);
+  return ateFim - posicaoChave(raiz, inicio);
+}
+
+// Função para posicionar o iterador na k-ésima menor chave (k começa em 0): seleção
+// Lógica:
+// Compara k com o tamanho da subárvore esquerda: se for menor, a chave está à esquerda; se for
+// igual, é o próprio nó; se for maior, desconta a esquerda e o nó e continua pela direita.
+// Se k estiver fora da árvore, o iterador fica no fim.
+void selecionar(struct IteradorAVL *it, struct No *raiz, int k)
+{
+  it->topo = 0;
+  if (k < 0 || k >= obterTamanho(raiz))
+    return;
+  while (raiz != NULL)
+  {
+    it->pilha[it->topo++] = raiz;
+    int esquerda = obterTamanho(raiz->esquerda);
+    if (k == esquerda)
+      return;
+    if (k < esquerda)
+    {
+      raiz = raiz->esquerda;
+    }
+    else
+    {
+      k -= esquerda + 1;
+      raiz = raiz->direita;
+    }
+  }
+}
+#endif
+
+// Gerador pseudoaleatório (xorshift) para o benchmark: a mesma semente gera as mesmas chaves
+// para as duas versões.
+unsigned int proximoAleatorio(unsigned int *estado)
+{
+  unsigned int x = *estado;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *estado = x;
+  return x;
+}
+
+// Função de benchmark: versões recursivas x iterativas x compacta
+// Descrição:
+// Insere n chaves aleatórias e depois remove todas, medindo o tempo de cada fase em cada versão.
+
+void benchmarkAVL(int n)
+{
+  unsigned int estado;
+  clock_t inicio;
+  double tempos[6];
+
+  // Aquecimento: as duas versões medidas encontram o alocador no mesmo estado (nós reaproveitados
+  // de uma árvore já liberada), senão a segunda medição sairia prejudicada
+  struct No *raiz = NULL;
+  estado = 54321;
+  for (int i = 0; i < n; i++)
+    inserirIterativo(&raiz, (int)(proximoAleatorio(&estado) >> 1));
+  liberarArvore(raiz);
+
+  // Versão recursiva
+  raiz = NULL;
+  estado = 12345;
+  inicio = clock();
+  for (int i = 0; i < n; i++)
+    raiz = inserir(raiz, (int)(proximoAleatorio(&estado) >> 1));
+  tempos[0] = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+  int alturaRecursiva = obterAltura(raiz);
+  estado = 12345;
+  inicio = clock();
+  for (int i = 0; i < n; i++)
+    raiz = remover(raiz, (int)(proximoAleatorio(&estado) >> 1));
+  tempos[1] = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+  liberarArvore(raiz);
+
+  // Versão iterativa
+  raiz = NULL;
+  estado = 12345;
+  inicio = clock();
+  for (int i = 0; i < n; i++)
+    inserirIterativo(&raiz, (int)(proximoAleatorio(&estado) >> 1));
+  tempos[2] = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+  int alturaIterativa = obterAltura(raiz);
+  estado = 12345;
+  inicio = clock();
+  for (int i = 0; i < n; i++)
+    removerIterativo(&raiz, (int)(proximoAleatorio(&estado) >> 1));
+  tempos[3] = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+  liberarArvore(raiz);
+
+  // Versão compacta (vetor de nós com índices)
+  struct ArvoreCompacta *compacta = criarArvoreCompacta();
+  estado = 12345;
+  inicio = clock();
+  for (int i = 0; i < n; i++)
+    inserirCompacta(compacta, (int)(proximoAleatorio(&estado) >> 1));
+  tempos[4] = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+  estado = 12345;
+  inicio = clock();
+  for (int i = 0; i < n; i++)
+    removerCompacta(compacta, (int)(proximoAleatorio(&estado) >> 1));
+  tempos[5] = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+  liberarArvoreCompacta(compacta);
+
+  printf("%d chaves (altura %d / %d)\n", n, alturaRecursiva, alturaIterativa);
+  printf("Insercao: recursiva %.3f s, iterativa %.3f s (%.2fx), compacta %.3f s (%.2fx)\n", tempos[0], tempos[2],
+         tempos[2] > 0 ? tempos[0] / tempos[2] : 0, tempos[4], tempos[4] > 0 ? tempos[0] / tempos[4] : 0);
+  printf("Remocao:  recursiva %.3f s, iterativa %.3f s (%.2fx), compacta %.3f s (%.2fx)\n", tempos[1], tempos[3],
+         tempos[3] > 0 ? tempos[1] / tempos[3] : 0, tempos[5], tempos[5] > 0 ? tempos[1] / tempos[5] : 0);
+}
+
+// ---------------------------------------------------------------------------
+// Operações de conjunto (união, interseção e diferença) baseadas em junção e divisão
+// As duas árvores de entrada são consumidas: os nós são reaproveitados no resultado ou liberados.
+// Cada operação divide uma árvore pela chave da raiz da outra e resolve as duas metades de forma
+// independente, então as metades de subárvores grandes podem rodar em threads separadas.
+// ---------------------------------------------------------------------------
+
+// Função para juntar duas árvores com uma chave no meio
+// Descrição:
+// Recebe 'esquerda' e 'direita' (todas as chaves da esquerda < meio->chave < todas as da direita)
+// e devolve uma única árvore AVL com os três, em O(|altura(esquerda) - altura(direita)| + 1).
+
+// Lógica:
+
+// Se as alturas diferem em no máximo 1, 'meio' vira a raiz com as duas árvores como filhas.
+// Senão, desce pela borda direita da árvore mais alta (ou pela borda esquerda, se a mais alta for a
+// direita) até uma subárvore com altura próxima da outra, pendura ali 'meio' com as duas e
+// rebalanceia na volta com balancearNo(): em cada nível as alturas diferem em no máximo 2.
+
+struct No *juntarDireita(struct No *esquerda, struct No *meio, struct No *direita)
+{
+  if (obterAltura(esquerda) <= obterAltura(direita) + 1)
+  {
+    meio->esquerda = esquerda;
+    meio->direita = direita;
+    return balancearNo(meio);
+  }
+  esquerda->direita = juntarDireita(esquerda->direita, meio, direita);
+  return balancearNo(esquerda);
+}
+
+struct No *juntarEsquerda(struct No *esquerda, struct No *meio, struct No *direita)
+{
+  if (obterAltura(direita) <= obterAltura(esquerda) + 1)
+  {
+    meio->esquerda = esquerda;
+    meio->direita = direita;
+    return balancearNo(meio);
+  }
+  direita->esquerda = juntarEsquerda(esquerda, meio, direita->esquerda);
+  return balancearNo(direita);
+}
+
+struct No *juntar(struct No *esquerda, struct No *meio, struct No *direita)
+{
+  if (obterAltura(esquerda) > obterAltura(direita) + 1)
+    return juntarDireita(esquerda, meio, direita);
+  return juntarEsquerda(esquerda, meio, direita);
+}
+
+// Junta duas árvores sem chave no meio: o menor nó da direita faz esse papel
+struct No *juntarSemMeio(struct No *esquerda, struct No *direita)
+{
+  if (direita == NULL)
+    return esquerda;
+  struct No *minimo;
+  direita = removerMinimo(direita, &minimo);
+  return juntar(esquerda, minimo, direita);
+}
+
+// Função para dividir uma árvore pela chave
+// Descrição:
+// Separa a árvore em *esquerda (chaves menores) e *direita (chaves maiores), em O(log n).
+// Retorna o nó com a própria chave, já desligado (ou NULL se ela não estava na árvore).
+
+// Lógica:
+
+// Desce como numa busca. Ao passar por um nó pela esquerda, o nó e sua subárvore direita ficam
+// inteiros do lado direito: são juntados ao que a divisão da subárvore esquerda deixou à direita
+// (simétrico ao passar pela direita).
+
+struct No *dividir(struct No *raiz, int chave, struct No **esquerda, struct No **direita)
+{
+  if (raiz == NULL)
+  {
+    *esquerda = NULL;
+    *direita = NULL;
+    return NULL;
+  }
+  struct No *filhoEsquerdo = raiz->esquerda;
+  struct No *filhoDireito = raiz->direita;
+  struct No *encontrado;
+
+  if (chave == raiz->chave)
+  {
+    *esquerda = filhoEsquerdo;
+    *direita = filhoDireito;
+    raiz->esquerda = NULL;
+    raiz->direita = NULL;
+    return raiz;
+  }
+  if (chave < raiz->chave)
+  {
+    struct No *meioDireita;
+    encontrado = dividir(filhoEsquerdo, chave, esquerda, &meioDireita);
+    *direita = juntar(meioDireita, raiz, filhoDireito);
+  }
+  else
+  {
+    struct No *meioEsquerda;
+    encontrado = dividir(filhoDireito, chave, &meioEsquerda, direita);
+    *esquerda = juntar(filhoEsquerdo, raiz, meioEsquerda);
+  }
+  return encontrado;
+}
+
+#define UNIAO 0
+#define INTERSECAO 1
+#define DIFERENCA 2
+
+// Subárvores com altura a partir desta (uns 10 mil nós) podem ter as metades resolvidas em paralelo
+#define ALTURA_MINIMA_PARALELO 14
+
+// Threads extras que ainda podem ser criadas (definido por definirThreadsConjuntos())
+atomic_int threadsDisponiveis = 0;
+
+// Define quantas threads as operações de conjunto podem usar ao todo (1 = sequencial)
+void definirThreadsConjuntos(int numThreads)
+{
+  atomic_store(&threadsDisponiveis, numThreads > 1 ? numThreads - 1 : 0);
+}
+
+struct TarefaConjunto
+{
+  int operacao;
+  struct No *a;
+  struct No *b;
+  struct No *resultado;
+};
+
+struct No *operacaoConjunto(int operacao, struct No *a, struct No *b);
+
+void *executarTarefaConjunto(void *argumento)
+{
+  struct TarefaConjunto *tarefa = (struct TarefaConjunto *)argumento;
+  tarefa->resultado = operacaoConjunto(tarefa->operacao, tarefa->a, tarefa->b);
+  return NULL;
+}
+
+// Resolve as duas metades de uma operação (fork-join)
+// Se a subárvore é grande e ainda há thread disponível, a metade esquerda roda numa thread nova
+// enquanto a atual resolve a direita; senão as duas rodam aqui mesmo, em sequência.
+// O contador limita o total de threads vivas, que funcionam como um conjunto fixo de trabalhadores.
+void resolverMetades(struct TarefaConjunto *esquerda, struct TarefaConjunto *direita, int altura)
+{
+  pthread_t thread;
+  int paralelo = 0;
+
+  if (altura >= ALTURA_MINIMA_PARALELO)
+  {
+    if (atomic_fetch_sub(&threadsDisponiveis, 1) > 0)
+      paralelo = pthread_create(&thread, NULL, executarTarefaConjunto, esquerda) == 0;
+    if (!paralelo)
+      atomic_fetch_add(&threadsDisponiveis, 1);
+  }
+  if (!paralelo)
+    executarTarefaConjunto(esquerda);
+  executarTarefaConjunto(direita);
+  if (paralelo)
+  {
+    pthread_join(thread, NULL);
+    atomic_fetch_add(&threadsDisponiveis, 1);
+  }
+}
+
+// Função que executa união, interseção ou diferença (a - b)
+// Lógica:
+
+// Divide 'b' pela chave da raiz de 'a' (na diferença, divide 'a' pela raiz de 'b'), resolve
+// recursivamente as metades esquerdas entre si e as direitas entre si e junta os resultados:
+//  - união: a raiz de 'a' fica no meio; a cópia da chave vinda de 'b' é liberada;
+//  - interseção: a raiz de 'a' só fica se a chave também estava em 'b';
+//  - diferença: a chave da raiz de 'b' nunca fica no resultado.
+// Com árvores de tamanhos m <= n o trabalho é O(m log(n/m + 1)).
+
+struct No *operacaoConjunto(int operacao, struct No *a, struct No *b)
+{
+  if (a == NULL || b == NULL)
+  {
+    if (operacao == UNIAO)
+      return a != NULL ? a : b;
+    if (operacao == INTERSECAO)
+    {
+      liberarArvore(a != NULL ? a : b);
+      return NULL;
+    }
+    liberarArvore(b);
+    return a;
+  }
+
+  struct No *meio;
+  struct No *encontrado;
+  struct TarefaConjunto esquerda = {operacao, NULL, NULL, NULL};
+  struct TarefaConjunto direita = {operacao, NULL, NULL, NULL};
+  int altura = max(obterAltura(a), obterAltura(b));
+
+  if (operacao == DIFERENCA)
+  {
+    meio = b;
+    encontrado = dividir(a, b->chave, &esquerda.a, &direita.a);
+    esquerda.b = b->esquerda;
+    direita.b = b->direita;
+  }
+  else
+  {
+    meio = a;
+    encontrado = dividir(b, a->chave, &esquerda.b, &direita.b);
+    esquerda.a = a->esquerda;
+    direita.a = a->direita;
+  }
+
+  resolverMetades(&esquerda, &direita, altura);
+
+  if (operacao == UNIAO || (operacao == INTERSECAO && encontrado != NULL))
+  {
+    free(encontrado);
+    return juntar(esquerda.resultado, meio, direita.resultado);
+  }
+  free(encontrado);
+  free(meio);
+  return juntarSemMeio(esquerda.resultado, direita.resultado);
+}
+
+struct No *uniao(struct No *a, struct No *b) { return operacaoConjunto(UNIAO, a, b); }
+
+struct No *intersecao(struct No *a, struct No *b) { return operacaoConjunto(INTERSECAO, a, b); }
+
+struct No *diferenca(struct No *a, struct No *b) { return operacaoConjunto(DIFERENCA, a, b); }
+
+// Gera n chaves distintas e crescentes com passos aleatórios (para montar conjuntos de teste)
+int *gerarChavesOrdenadas(int n, unsigned int *estado)
+{
+  int *chaves = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+  int chave = 0;
+  for (int i = 0; i < n; i++)
+  {
+    chave += 1 + (int)(proximoAleatorio(estado) % 200);
+    chaves[i] = chave;
+  }
+  return chaves;
+}
+
+// Função de benchmark das operações de conjunto
+// Descrição:
+// Monta dois conjuntos de n chaves (com parte das chaves em comum) e mede a união feita chave a
+// chave com inserirIterativo() contra a união por junção com 1, 2, 4, ... até numThreads threads.
+
+void benchmarkConjuntos(int n, int numThreads)
+{
+  unsigned int estado = 2024;
+  int *chavesA = gerarChavesOrdenadas(n, &estado);
+  int *chavesB = gerarChavesOrdenadas(n, &estado);
+  clock_t inicioCpu;
+  struct timespec inicio, fim;
+
+  struct No *a = construirDeOrdenado(chavesA, n);
+  struct No *b = construirDeOrdenado(chavesB, n);
+  timespec_get(&inicio, TIME_UTC);
+  for (int i = 0; i < n; i++)
+    inserirIterativo(&a, chavesB[i]);
+  timespec_get(&fim, TIME_UTC);
+  printf("Uniao de %d + %d chaves: insercao uma a uma %.3f s (%zu chaves no resultado)\n", n, n,
+         (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9, contarNos(a));
+  liberarArvore(a);
+  liberarArvore(b);
+
+  for (int threads = 1;; threads = min(threads * 2, numThreads))
+  {
+    a = construirDeOrdenado(chavesA, n);
+    b = construirDeOrdenado(chavesB, n);
+    definirThreadsConjuntos(threads);
+    inicioCpu = clock();
+    timespec_get(&inicio, TIME_UTC);
+    a = uniao(a, b);
+    timespec_get(&fim, TIME_UTC);
+    printf("  juncao com %d thread(s): %.3f s (CPU %.3f s, %zu chaves, altura %d)\n", threads,
+           (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9,
+           (double)(clock() - inicioCpu) / CLOCKS_PER_SEC, contarNos(a), obterAltura(a));
+    liberarArvore(a);
+    if (threads >= numThreads)
+      break;
+  }
+  free(chavesA);
+  free(chavesB);
+}
+
+// ---------------------------------------------------------------------------
+// Snapshot da árvore em arquivo binário
+// Formato: MAGICA_SNAPSHOT_AVL (8 bytes), número de nós (uint32) e os nós em pré-ordem, 6 bytes
+// cada: chave (int32), altura (uint8) e um byte de filhos (bit 0 = tem esquerdo, bit 1 = tem direito).
+// A pré-ordem com os filhos descreve exatamente a forma da árvore, então a restauração refaz a
+// mesma árvore em O(n), sem inserir() nem rotações.
+// ---------------------------------------------------------------------------
+
+#define MAGICA_SNAPSHOT_AVL "AVLSNAP1"
+#define TAMANHO_REGISTRO_SNAPSHOT 6
+
+// Função para gravar a árvore em arquivo (via temporário, como salvarArvoreCompacta()). Retorna 1 se gravou.
+int salvarArvore(struct No *raiz, const char *nomeArquivo)
+{
+  char nomeTemporario[4096];
+  FILE *arquivo = abrirArquivoTemporario(nomeArquivo, nomeTemporario, sizeof(nomeTemporario));
+  if (arquivo == NULL)
+    return 0;
+
+  uint32_t numNos = (uint32_t)contarNos(raiz);
+  unsigned char *dados = (unsigned char *)malloc((size_t)numNos * TAMANHO_REGISTRO_SNAPSHOT + 1);
+  unsigned char *registro = dados;
+  struct No *pilha[MAX_ALTURA_AVL + 1];
+  int topo = 0;
+
+  if (raiz != NULL)
+    pilha[topo++] = raiz;
+  while (topo > 0)
+  {
+    struct No *no = pilha[--topo];
+    int32_t chave = no->chave;
+    memcpy(registro, &chave, sizeof(chave));
+    registro[4] = (unsigned char)no->altura;
+    registro[5] = (no->esquerda != NULL ? 1 : 0) | (no->direita != NULL ? 2 : 0);
+    registro += TAMANHO_REGISTRO_SNAPSHOT;
+    // O direito é empilhado primeiro para o esquerdo sair antes (pré-ordem)
+    if (no->direita != NULL)
+      pilha[topo++] = no->direita;
+    if (no->esquerda != NULL)
+      pilha[topo++] = no->esquerda;
+  }
+
+  int ok = fwrite(MAGICA_SNAPSHOT_AVL, 1, 8, arquivo) == 8 &&
+           fwrite(&numNos, sizeof(numNos), 1, arquivo) == 1 &&
+           fwrite(dados, TAMANHO_REGISTRO_SNAPSHOT, numNos, arquivo) == numNos;
+  free(dados);
+  return concluirArquivoTemporario(arquivo, nomeTemporario, nomeArquivo, ok);
+}
+
+// Função para restaurar uma árvore gravada por salvarArvore()
+// Descrição:
+// Lê o arquivo inteiro de uma vez e recria os nós na ordem em que aparecem. Retorna 1 e a árvore
+// em *raizPtr, ou 0 se o arquivo não existe ou não é um snapshot válido (e *raizPtr fica intacto).
+
+// Lógica:
+
+// Uma pilha guarda as posições ainda vazias (ponteiros para os campos 'esquerda'/'direita' já
+// alocados): cada registro ocupa a do topo e empilha as posições dos filhos que ele diz ter.
+// Depois, percorre os nós da última para a primeira: na pré-ordem invertida os filhos vêm antes
+// do pai, então as alturas gravadas são conferidas (e os tamanhos calculados) numa única passada.
+// Por fim, um percurso em ordem confere se as chaves estão ordenadas.
+
+int carregarArvore(const char *nomeArquivo, struct No **raizPtr)
+{
+  FILE *arquivo = fopen(nomeArquivo, "rb");
+  if (arquivo == NULL)
+    return 0;
+
+  char magica[8];
+  uint32_t numNos;
+  fseek(arquivo, 0, SEEK_END);
+  long tamanho = ftell(arquivo);
+  fseek(arquivo, 0, SEEK_SET);
+  if (fread(magica, 1, 8, arquivo) != 8 || memcmp(magica, MAGICA_SNAPSHOT_AVL, 8) != 0 ||
+      fread(&numNos, sizeof(numNos), 1, arquivo) != 1 ||
+      tamanho != 8 + (long)sizeof(numNos) + (long)numNos * TAMANHO_REGISTRO_SNAPSHOT)
+  {
+    fclose(arquivo);
+    return 0;
+  }
+  unsigned char *dados = (unsigned char *)malloc((size_t)numNos * TAMANHO_REGISTRO_SNAPSHOT + 1);
+  struct No **nos = (struct No **)malloc(((size_t)numNos + 1) * sizeof(struct No *));
+  int ok = fread(dados, TAMANHO_REGISTRO_SNAPSHOT, numNos, arquivo) == numNos;
+  fclose(arquivo);
+
+  struct No *raiz = NULL;
+  struct No **pendentes[MAX_ALTURA_AVL + 1];
+  int topo = 0;
+  uint32_t criados = 0;
+
+  if (ok && numNos > 0)
+    pendentes[topo++] = &raiz;
+  for (unsigned char *registro = dados; ok && criados < numNos; registro += TAMANHO_REGISTRO_SNAPSHOT)
+  {
+    if (topo == 0)
+    {
+      ok = 0;
+      break;
+    }
+    int32_t chave;
+    memcpy(&chave, registro, sizeof(chave));
+    struct No *no = criarNo(chave);
+    no->altura = registro[4];
+    *pendentes[--topo] = no;
+    nos[criados++] = no;
+
+    if (topo + 2 > MAX_ALTURA_AVL + 1)
+      ok = 0;
+    else
+    {
+      if (registro[5] & 2)
+        pendentes[topo++] = &no->direita;
+      if (registro[5] & 1)
+        pendentes[topo++] = &no->esquerda;
+    }
+  }
+  if (topo != 0)
+    ok = 0;
+
+  // Confere as alturas de baixo para cima (e calcula os tamanhos)
+  for (uint32_t i = criados; ok && i > 0; i--)
+  {
+    struct No *no = nos[i - 1];
+    atualizarTamanho(no);
+    if (no->altura != 1 + max(obterAltura(no->esquerda), obterAltura(no->direita)) ||
+        obterFatorBalanceamento(no) > 1 || obterFatorBalanceamento(no) < -1)
+      ok = 0;
+  }
+  // Confere se as chaves estão em ordem crescente no percurso em ordem
+  if (ok)
+  {
+    struct IteradorAVL it;
+    iteradorInicio(&it, raiz);
+    for (int anterior = 0, primeira = 1; ok && iteradorValido(&it); primeira = 0, iteradorProximo(&it))
+    {
+      if (!primeira && iteradorChave(&it) <= anterior)
+        ok = 0;
+      anterior = iteradorChave(&it);
+    }
+  }
+
+  if (ok)
+  {
+    liberarArvore(*raizPtr);
+    *raizPtr = raiz;
+  }
+  else
+  {
+    for (uint32_t i = 0; i < criados; i++)
+      free(nos[i]);
+  }
+  free(nos);
+  free(dados);
+  return ok;
+}
+
+// Uso: arvoreAVL [arquivo de chaves | snapshot | -]
+// Com um arquivo, a árvore começa com as chaves dele (ou é restaurada, se for um snapshot gravado
+// pela opção 21); com '-', as chaves vêm da entrada padrão e o programa termina depois de mostrar o resultado.
+int main(int argc, char *argv[])
+{
+  struct No *raiz = NULL;
+  struct ArvoreCompacta *compactaCarregada = NULL; // árvore compacta aberta pela opção 11
+  int opcao, chave;
+  char nomeArquivo[256];
+
+  if (argc > 1 && carregarArvore(argv[1], &raiz))
+  {
+    printf("Snapshot restaurado: %zu chaves, altura %d\n", contarNos(raiz), obterAltura(raiz));
+  }
+  else if (argc > 1)
+  {
+    FILE *entrada = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "r");
+    if (entrada == NULL)
+    {
+      printf("Nao foi possivel abrir %s\n", argv[1]);
+      return 1;
+    }
+    carregarEmLote(&raiz, entrada);
+    if (entrada == stdin)
+    {
+      liberarArvore(raiz);
+      return 0;
+    }
+    fclose(entrada);
+  }
+  else
+  {
+    raiz = inserir(raiz, 1);
+    raiz = inserir(raiz, 2);
+    raiz = inserir(raiz, 4);
+    raiz = inserir(raiz, 5);
+    raiz = inserir(raiz, 6);
+    raiz = inserir(raiz, 3);
+  }
+
+  do
+  {
+    printf("\nMenu:\n");
+    printf("1. Inserir\n");
+    printf("2. Remover\n");
+    printf("3. Buscar\n");
+    printf("4. Exibir pré-ordem\n");
+    printf("5. Exibir em ordem\n");
+    printf("6. Exibir pós-ordem\n");
+    printf("7. Exibir árvore\n");
+    printf("8. Sair\n");
+    printf("9. Benchmark (recursiva x iterativa x compacta)\n");
+    printf("10. Salvar arvore em formato compacto\n");
+    printf("11. Carregar arvore compacta (mmap)\n");
+    printf("12. Demonstracao dos mapas (ID -> registro, texto -> registro)\n");
+    printf("13. Carregar chaves de arquivo\n");
+    printf("14. Listar chaves num intervalo\n");
+    printf("15. Exibir em ordem decrescente\n");
+#ifndef AVL_SEM_TAMANHO
+    printf("16. Posicao de uma chave\n");
+    printf("17. k-esima menor chave\n");
+    printf("18. Listar pagina\n");
+#endif
+    printf("19. Uniao/intersecao/diferenca com chaves de arquivo\n");
+    printf("20. Benchmark de operacoes de conjunto\n");
+    printf("21. Salvar snapshot da arvore\n");
+    printf("22. Restaurar snapshot\n");
+    printf("23. Buscar na arvore compacta carregada\n");
+    printf("24. Exibir a arvore compacta carregada em ordem\n");
+    printf("25. Copiar a arvore compacta carregada para a arvore do menu\n");
+    printf("Escolha uma opcao: ");
+    scanf("%d", &opcao);
+    switch (opcao)
+    {
+    case 1:
+      printf("Digite o valor a ser inserido: ");
+      scanf("%d", &chave);
+      if (!inserirIterativo(&raiz, chave))
+        printf("Valor ja existe na arvore.\n");
+      break;
+    case 2:
+      printf("Digite o valor a ser removido: ");
+      scanf("%d", &chave);
+      if (removerIterativo(&raiz, chave))
+        printf("Valor removido.\n");
+      else
+        printf("Valor nao encontrado.\n");
+      break;
+    case 3:
+      printf("Digite o valor a ser buscado: ");
+      scanf("%d", &chave);
+      if (buscar(raiz, chave) != NULL)
+        printf("Valor encontrado!\n");
+      else
+        printf("Valor nao encontrado.\n");
+      break;
+    case 4:
+      printf("Percurso pré-ordem: ");
+      preOrdem(raiz);
+      printf("\n");
+      break;
+    case 5:
+      printf("Percurso em ordem: ");
+      emOrdem(raiz);
+      printf("\n");
+      break;
+    case 6:
+      printf("Percurso pós-ordem: ");
+      posOrdem(raiz);
+      printf("\n");
+      break;
+    case 7:
+      printf("\nEstrutura da árvore AVL:\n");
+      exibirArvore(raiz, 0);
+      break;
+    case 8:
+      printf("Saindo...\n");
+      break;
+    case 9:
+      printf("Quantidade de chaves: ");
+      scanf("%d", &chave);
+      benchmarkAVL(chave);
+      break;
+    case 10:
+    {
+      printf("Nome do arquivo: ");
+      scanf("%255s", nomeArquivo);
+      struct ArvoreCompacta *compacta = criarArvoreCompacta();
+      copiarParaCompacta(raiz, compacta);
+      if (salvarArvoreCompacta(compacta, nomeArquivo))
+        printf("%u chaves gravadas (%u bytes por no).\n", compacta->numChaves, (unsigned int)sizeof(struct NoCompacto));
+      else
+        printf("Erro ao gravar o arquivo.\n");
+      liberarArvoreCompacta(compacta);
+      break;
+    }
+    case 11:
+    {
+      printf("Nome do arquivo: ");
+      scanf("%255s", nomeArquivo);
+      struct ArvoreCompacta *compacta = carregarArvoreCompacta(nomeArquivo);
+      if (compacta == NULL)
+      {
+        printf("Arquivo invalido ou inexistente.\n");
+        break;
+      }
+      // A árvore fica mapeada: as opções 23 a 25 consultam e alteram direto nela
+      liberarArvoreCompacta(compactaCarregada);
+      compactaCarregada = compacta;
+      printf("%u chaves carregadas (opcoes 23 a 25 usam esta arvore).\n", compacta->numChaves);
+      break;
+    }
+    case 12:
+      demonstrarMapas();
+      break;
+    case 13:
+    {
+      printf("Nome do arquivo: ");
+      scanf("%255s", nomeArquivo);
+      FILE *entrada = fopen(nomeArquivo, "r");
+      if (entrada == NULL)
+      {
+        printf("Nao foi possivel abrir o arquivo.\n");
+        break;
+      }
+      carregarEmLote(&raiz, entrada);
+      fclose(entrada);
+      break;
+    }
+    case 14:
+    {
+      int inicio, fim;
+      struct IteradorAVL it;
+      printf("Inicio e fim do intervalo: ");
+      scanf("%d %d", &inicio, &fim);
+      printf("Chaves em [%d, %d]: ", inicio, fim);
+      for (lowerBound(&it, raiz, inicio); iteradorValido(&it) && iteradorChave(&it) <= fim; iteradorProximo(&it))
+        printf("%d ", iteradorChave(&it));
+      printf("\n");
+#ifndef AVL_SEM_TAMANHO
+      printf("Total: %d\n", contarIntervalo(raiz, inicio, fim));
+#endif
+      break;
+    }
+    case 15:
+    {
+      struct IteradorAVL it;
+      printf("Percurso em ordem decrescente: ");
+      for (iteradorUltimo(&it, raiz); iteradorValido(&it); iteradorAnterior(&it))
+        printf("%d ", iteradorChave(&it));
+      printf("\n");
+      break;
+    }
+#ifndef AVL_SEM_TAMANHO
+    case 16:
+      printf("Digite a chave: ");
+      scanf("%d", &chave);
+      printf("%d chaves menores que %d (de %d)%s\n", posicaoChave(raiz, chave), chave, obterTamanho(raiz),
+             buscar(raiz, chave) != NULL ? "" : "; a chave nao esta na arvore");
+      break;
+    case 17:
+    {
+      struct IteradorAVL it;
+      printf("Digite k (a partir de 0): ");
+      scanf("%d", &chave);
+      selecionar(&it, raiz, chave);
+      if (iteradorValido(&it))
+        printf("A chave de posicao %d e %d\n", chave, iteradorChave(&it));
+      else
+        printf("A arvore tem so %d chaves.\n", obterTamanho(raiz));
+      break;
+    }
+    case 18:
+    {
+      int pagina, porPagina;
+      struct IteradorAVL it;
+      printf("Numero da pagina (a partir de 0) e chaves por pagina: ");
+      scanf("%d %d", &pagina, &porPagina);
+      if (pagina < 0 || porPagina <= 0)
+      {
+        printf("Valores invalidos.\n");
+        break;
+      }
+      printf("Pagina %d: ", pagina);
+      selecionar(&it, raiz, (int)((long long)pagina * porPagina > INT_MAX ? INT_MAX : pagina * porPagina));
+      for (int i = 0; i < porPagina && iteradorValido(&it); i++, iteradorProximo(&it))
+        printf("%d ", iteradorChave(&it));
+      printf("\n");
+      break;
+    }
+#endif
+    case 19:
+    {
+      int operacao, numThreads;
+      printf("Nome do arquivo: ");
+      scanf("%255s", nomeArquivo);
+      FILE *entrada = fopen(nomeArquivo, "r");
+      if (entrada == NULL)
+      {
+        printf("Nao foi possivel abrir o arquivo.\n");
+        break;
+      }
+      struct No *outra = NULL;
+      carregarEmLote(&outra, entrada);
+      fclose(entrada);
+      printf("1. Uniao  2. Intersecao  3. Diferenca (arvore - arquivo)  4. Diferenca (arquivo - arvore): ");
+      scanf("%d", &operacao);
+      printf("Numero de threads: ");
+      scanf("%d", &numThreads);
+      definirThreadsConjuntos(numThreads);
+      if (operacao == 1)
+        raiz = uniao(raiz, outra);
+      else if (operacao == 2)
+        raiz = intersecao(raiz, outra);
+      else if (operacao == 3)
+        raiz = diferenca(raiz, outra);
+      else if (operacao == 4)
+        raiz = diferenca(outra, raiz);
+      else
+      {
+        printf("Opcao invalida!\n");
+        liberarArvore(outra);
+        break;
+      }
+      printf("%zu chaves na arvore, altura %d\n", contarNos(raiz), obterAltura(raiz));
+      break;
+    }
+    case 20:
+    {
+      int numThreads;
+      printf("Quantidade de chaves em cada conjunto e numero maximo de threads: ");
+      scanf("%d %d", &chave, &numThreads);
+      benchmarkConjuntos(chave, numThreads);
+      break;
+    }
+    case 21:
+      printf("Nome do arquivo: ");
+      scanf("%255s", nomeArquivo);
+      if (salvarArvore(raiz, nomeArquivo))
+        printf("%zu chaves gravadas.\n", contarNos(raiz));
+      else
+        printf("Erro ao gravar o arquivo.\n");
+      break;
+    case 22:
+    {
+      struct timespec inicio, fim;
+      printf("Nome do arquivo: ");
+      scanf("%255s", nomeArquivo);
+      timespec_get(&inicio, TIME_UTC);
+      if (carregarArvore(nomeArquivo, &raiz))
+      {
+        timespec_get(&fim, TIME_UTC);
+        printf("%zu chaves restauradas em %.1f ms, altura %d\n", contarNos(raiz),
+               ((fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9) * 1000, obterAltura(raiz));
+      }
+      else
+        printf("Arquivo invalido ou inexistente.\n");
+      break;
+    }
+    case 23:
+    case 24:
+    case 25:
+      if (compactaCarregada == NULL)
+      {
+        printf("Nenhuma arvore compacta carregada (opcao 11).\n");
+      }
+      else if (opcao == 23)
+      {
+        printf("Digite o valor a ser buscado: ");
+        scanf("%d", &chave);
+        if (buscarCompacta(compactaCarregada, chave) != 0)
+          printf("Valor encontrado!\n");
+        else
+          printf("Valor nao encontrado.\n");
+      }
+      else if (opcao == 24)
+      {
+        printf("Percurso em ordem: ");
+        emOrdemCompacta(compactaCarregada);
+        printf("\n");
+      }
+      else
+      {
+        liberarArvore(raiz);
+        raiz = NULL;
+        copiarDeCompacta(compactaCarregada, compactaCarregada->raiz, &raiz);
+        printf("%zu chaves copiadas.\n", contarNos(raiz));
+      }
       break;
     default:
       printf("Opcao invalida!\n");
     }
   } while (opcao != 8);
+  liberarArvore(raiz);
+  liberarArvoreCompacta(compactaCarregada);
   return 0;
 }
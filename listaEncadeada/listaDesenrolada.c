@@ -0,0 +1,431 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Lista duplamente encadeada "desenrolada": cada nó (bloco) guarda um pequeno vetor de valores
+// em vez de um só. Na lista comum cada int ocupa um nó de 24 bytes (mais o cabeçalho do malloc)
+// e percorrer a lista é um acesso a memória espalhada por elemento; aqui um bloco de 128 bytes
+// guarda 27 valores contíguos, então as varreduras leem a memória em sequência.
+// As operações são as mesmas de listaDuplamenteEncadeada.c.
+
+// quantos valores cabem num bloco de 128 bytes (27 em 64 bits)
+#define VALORES_POR_BLOCO ((128 - 2 * sizeof(void *) - sizeof(int)) / sizeof(int))
+
+// bloco da lista: valores[0..quantidade-1] estão em uso, na ordem da lista
+typedef struct bloco {
+    struct bloco *anterior;
+    struct bloco *proximo;
+    int quantidade;
+    int valores[VALORES_POR_BLOCO];
+} bloco;
+
+// struct de lista para facilitar acesso a cabeça e à cauda
+typedef struct list {
+    bloco *cabeca;
+    bloco *cauda;
+} list;
+
+
+void init_list(list *mylist);
+
+void inserir_inicio(list *myList, int value);
+
+void inserir_meio(list *myList, int value, int ant);
+
+void inserir_fim(list *myList, int value);
+
+int* buscar(list *myList, int value);
+
+void remover_inicio(list *myList, int value);
+
+void remover_final(list *myList, int value);
+
+void remover_elemento(list *myList, int value);
+
+void mostrar_crescente(list *myList);
+
+void mostrar_decrescente(list *myList);
+
+void liberar_memoria(list *myList);
+
+int main(void)
+{
+
+    // Criar lista e alocar memória
+    list *lista_numeros = (list *)malloc(sizeof(list));
+    if (lista_numeros == NULL)
+    {
+        fprintf(stderr, "Erro: falha na alocação de memória.\n");
+        return 1;
+    }
+
+    init_list(lista_numeros);
+
+    // Variáveis para controle do menu
+    int opcao = -1;
+    int numero, elemento_ref;
+
+    // Loop principal do programa
+    while (opcao != 0)
+    {
+        // Exibir menu de opções
+        printf("\n===== GERENCIADOR DE LISTA (DESENROLADA) =====\n");
+        printf("[1] Inserir no início\n");
+        printf("[2] Inserir no fim\n");
+        printf("[3] Inserir após elemento específico\n");
+        printf("[4] Eliminar elemento\n");
+        printf("[5] Exibir em ordem crescente\n");
+        printf("[6] Exibir em ordem decrescente\n");
+        printf("[7] Localizar elemento\n");
+        printf("[0] Encerrar programa\n");
+        printf("\nDigite sua escolha: ");
+        if (scanf("%d", &opcao) != 1)
+            opcao = 0;
+
+        // Processar escolha do usuário
+        switch (opcao)
+        {
+        case 1:
+            printf("Informe o número para inserir no início: ");
+            scanf("%d", &numero);
+            inserir_inicio(lista_numeros, numero);
+            break;
+
+        case 2:
+            printf("Informe o número para inserir no fim: ");
+            scanf("%d", &numero);
+            inserir_fim(lista_numeros, numero);
+            break;
+
+        case 3:
+            printf("Informe o número a ser inserido: ");
+            scanf("%d", &numero);
+            printf("Informe o elemento de referência: ");
+            scanf("%d", &elemento_ref);
+            inserir_meio(lista_numeros, numero, elemento_ref);
+            break;
+
+        case 4:
+            printf("Informe o número a ser eliminado: ");
+            scanf("%d", &numero);
+            remover_elemento(lista_numeros, numero);
+            break;
+
+        case 5:
+            printf("\nConteúdo da lista (crescente): ");
+            mostrar_crescente(lista_numeros);
+            break;
+
+        case 6:
+            printf("\nConteúdo da lista (decrescente): ");
+            mostrar_decrescente(lista_numeros);
+            break;
+
+        case 7:
+            printf("Informe o número a ser localizado: ");
+            scanf("%d", &numero);
+            int *elemento = buscar(lista_numeros, numero);
+            if (elemento != NULL)
+            {
+                printf("✓ Elemento %d encontrado na lista!\n", *elemento);
+            }
+            else
+            {
+                printf("✗ Elemento %d não existe na lista.\n", numero);
+            }
+            break;
+
+        case 0:
+            printf("\nFinalizando programa...\n");
+            break;
+
+        default:
+            printf("\n[ERRO] Opção inválida! Tente novamente.\n");
+        }
+    }
+
+    // Liberar memória antes de encerrar
+    liberar_memoria(lista_numeros);
+    free(lista_numeros);
+    printf("Memória liberada com sucesso!\n");
+
+    return 0;
+}
+
+// inicializa a lista
+void init_list(list *mylist)
+{
+    mylist->cabeca = NULL;
+    mylist->cauda = NULL;
+}
+
+// cria um bloco vazio e o liga depois de "ant" (ou no início da lista, se ant for NULL)
+static bloco *novo_bloco(list *myList, bloco *ant)
+{
+    bloco *novo = (bloco *)malloc(sizeof(bloco));
+    if (novo == NULL)
+    {
+        fprintf(stderr, "[ERRO] Falha na alocação de memória!\n");
+        return NULL;
+    }
+    novo->quantidade = 0;
+    novo->anterior = ant;
+    novo->proximo = ant ? ant->proximo : myList->cabeca;
+
+    if (novo->proximo)
+        novo->proximo->anterior = novo;
+    else
+        myList->cauda = novo;
+
+    if (ant)
+        ant->proximo = novo;
+    else
+        myList->cabeca = novo;
+
+    return novo;
+}
+
+// desliga o bloco da lista e libera a memória
+static void remover_bloco(list *myList, bloco *b)
+{
+    if (b->anterior)
+        b->anterior->proximo = b->proximo;
+    else
+        myList->cabeca = b->proximo;
+
+    if (b->proximo)
+        b->proximo->anterior = b->anterior;
+    else
+        myList->cauda = b->anterior;
+
+    free(b);
+}
+
+// coloca value na posição "indice" do bloco, que precisa ter espaço
+static void inserir_no_bloco(bloco *b, int indice, int value)
+{
+    memmove(&b->valores[indice + 1], &b->valores[indice], (b->quantidade - indice) * sizeof(int));
+    b->valores[indice] = value;
+    b->quantidade++;
+}
+
+// tira o valor da posição "indice" do bloco; o bloco que fica vazio sai da lista, e um bloco
+// que fica com menos da metade dos valores absorve o próximo se os dois couberem num só
+static void remover_do_bloco(list *myList, bloco *b, int indice)
+{
+    memmove(&b->valores[indice], &b->valores[indice + 1], (b->quantidade - indice - 1) * sizeof(int));
+    b->quantidade--;
+
+    if (b->quantidade == 0)
+    {
+        remover_bloco(myList, b);
+    }
+    else if (b->quantidade < (int)VALORES_POR_BLOCO / 2 && b->proximo &&
+             b->quantidade + b->proximo->quantidade <= (int)VALORES_POR_BLOCO)
+    {
+        memcpy(&b->valores[b->quantidade], b->proximo->valores, b->proximo->quantidade * sizeof(int));
+        b->quantidade += b->proximo->quantidade;
+        remover_bloco(myList, b->proximo);
+    }
+}
+
+// adiciona valor ao inicio da lista
+void inserir_inicio(list *myList, int value)
+{
+    bloco *b = myList->cabeca;
+
+    // se a cabeça está cheia (ou a lista vazia), começa um bloco novo antes dela
+    if (b == NULL || b->quantidade == (int)VALORES_POR_BLOCO)
+        b = novo_bloco(myList, NULL);
+
+    if (b != NULL)
+        inserir_no_bloco(b, 0, value);
+}
+
+void inserir_fim(list *myList, int value)
+{
+    bloco *b = myList->cauda;
+
+    // se a cauda está cheia (ou a lista vazia), abre um bloco novo depois dela
+    if (b == NULL || b->quantidade == (int)VALORES_POR_BLOCO)
+        b = novo_bloco(myList, myList->cauda);
+
+    if (b != NULL)
+        b->valores[b->quantidade++] = value;
+}
+
+// procura value e devolve o bloco e a posição dentro dele (-1 se não existir)
+static int localizar(list *myList, int value, bloco **encontrado)
+{
+    // Verifica se a lista está vazia
+    if (myList->cabeca == NULL)
+    {
+        printf("\n[AVISO] Lista vazia - busca não realizada!\n");
+        return -1;
+    }
+
+    // os valores de cada bloco são contíguos: o laço interno percorre memória em sequência
+    for (bloco *b = myList->cabeca; b != NULL; b = b->proximo)
+    {
+        for (int i = 0; i < b->quantidade; i++)
+        {
+            if (b->valores[i] == value)
+            {
+                *encontrado = b;
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+// devolve o endereço do valor na lista (válido até a próxima inserção ou remoção)
+int *buscar(list *myList, int value)
+{
+    bloco *b;
+    int indice = localizar(myList, value, &b);
+    if (indice < 0)
+    {
+        return NULL; // Elemento não encontrado na lista
+    }
+    return &b->valores[indice];
+}
+
+// adiciona depois do numero "ant" informado
+void inserir_meio(list *myList, int value, int ant)
+{
+    // 1. busca o bloco e a posição do valor ant
+    bloco *b = NULL;
+    int indice = localizar(myList, ant, &b);
+
+    // 1.1 se ele não existe
+    if (indice < 0)
+    {
+        printf("\nvalor de referencia %d não encontrado\n", ant);
+        return;
+    }
+
+    // 2. se o bloco está cheio, divide: a segunda metade vai para um bloco novo logo depois dele
+    if (b->quantidade == (int)VALORES_POR_BLOCO)
+    {
+        bloco *novo = novo_bloco(myList, b);
+        if (novo == NULL)
+            return;
+
+        int metade = b->quantidade / 2;
+        novo->quantidade = b->quantidade - metade;
+        memcpy(novo->valores, &b->valores[metade], novo->quantidade * sizeof(int));
+        b->quantidade = metade;
+
+        // 2.1 se ant foi para o bloco novo, a posição passa a ser relativa a ele
+        if (indice >= metade)
+        {
+            indice -= metade;
+            b = novo;
+        }
+    }
+
+    // 3. abre espaço logo depois de ant
+    inserir_no_bloco(b, indice + 1, value);
+}
+
+void remover_inicio(list *myList, int value)
+{
+    (void)value;
+    if (myList->cabeca)
+    {
+        remover_do_bloco(myList, myList->cabeca, 0);
+    }
+    else
+    {
+        printf("lista vazia\n");
+    }
+}
+
+void remover_final(list *myList, int value)
+{
+    (void)value;
+    if (myList->cauda)
+    {
+        // o último valor da cauda sai sem mover nenhum outro
+        bloco *b = myList->cauda;
+        remover_do_bloco(myList, b, b->quantidade - 1);
+    }
+    else
+    {
+        printf("lista vazia\n");
+    }
+}
+
+void remover_elemento(list *myList, int value)
+{
+    // 1. buscar elemento value na lista
+    bloco *b = NULL;
+    int indice = localizar(myList, value, &b);
+
+    // 1.1 se o elemento for encontrado
+    if (indice >= 0)
+    {
+        remover_do_bloco(myList, b, indice);
+    }
+    // 1.2 se o elemento não for encontrado
+    else
+    {
+        printf("elemento %d não encontrado\n", value);
+    }
+}
+
+void mostrar_crescente(list *myList)
+{
+    bloco *ptr = myList->cabeca;
+
+    if (ptr)
+    {
+        while (ptr)
+        {
+            for (int i = 0; i < ptr->quantidade; i++)
+                printf("%d ", ptr->valores[i]);
+            ptr = ptr->proximo;
+        }
+        printf("\n");
+    }
+    else
+    {
+        printf("lista vazia\n");
+    }
+}
+
+void mostrar_decrescente(list *myList)
+{
+    bloco *ptr = myList->cauda;
+
+    if (ptr)
+    {
+        while (ptr)
+        {
+            for (int i = ptr->quantidade - 1; i >= 0; i--)
+                printf("%d ", ptr->valores[i]);
+            ptr = ptr->anterior;
+        }
+        printf("\n");
+    }
+    else
+    {
+        printf("lista vazia\n");
+    }
+}
+
+void liberar_memoria(list *myList)
+{
+    bloco *ptr = myList->cabeca;
+
+    while (ptr)
+    {
+        bloco *prox = ptr->proximo;
+        free(ptr);
+        ptr = prox;
+    }
+
+    myList->cabeca = NULL;
+    myList->cauda = NULL;
+}
@@ -1,5 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 // nó para lista duplamente encadeada
 typedef struct node {
@@ -8,12 +10,67 @@ typedef struct node {
     struct node *proximo;
 } node;
 
+// entrada do índice: valor -> nó que o contém (no == NULL marca posição livre)
+typedef struct entrada_indice {
+    int valor;
+    node *no;
+} entrada_indice;
+
+// índice hash opcional (endereçamento aberto com sondagem linear, capacidade potência de 2).
+// com o índice ligado, buscar, inserir_meio e remover_elemento deixam de percorrer a lista,
+// e os valores da lista passam a ser únicos (inserir um valor repetido é recusado)
+typedef struct indice {
+    entrada_indice *entradas;
+    unsigned int capacidade;
+    unsigned int quantidade;
+} indice;
+
+// bloco de nós alocado de uma vez pelo pool
+typedef struct slab {
+    struct slab *proximo;
+    unsigned int capacidade;
+    unsigned int usados; // nós do vetor já entregues alguma vez
+    node nos[];
+} slab;
+
+// pool de nós da lista: os nós removidos voltam para uma lista de livres (encadeados por
+// 'proximo') e são reaproveitados; quando não há livres, o nó sai do slab mais recente, e um
+// slab novo (com o dobro do anterior, até NOS_POR_SLAB_MAX) só é alocado quando ele esgota
+typedef struct pool_nos {
+    slab *slabs;
+    node *livres;
+    // contadores para monitoramento
+    unsigned long slabs_alocados;
+    unsigned long nos_em_slabs;       // capacidade total dos slabs
+    unsigned long nos_entregues;      // nós entregues às inserções
+    unsigned long nos_reaproveitados; // dos entregues, quantos vieram da lista de livres
+    unsigned long nos_devolvidos;     // nós devolvidos por remoções e por liberar_memoria
+} pool_nos;
+
+#define NOS_POR_SLAB_MIN 16
+#define NOS_POR_SLAB_MAX 4096
+
 // struct de lista para facilitar acesso a cabeça e à cauda
 typedef struct list {
     node *cabeca;
     node *cauda;
+    indice *indice; // NULL = sem índice
+    unsigned long tamanho;
+    pool_nos pool;
 }list;
 
+// cache LRU sobre a lista: o mais recente fica na cabeça, o menos recente na cauda
+typedef struct lru {
+    list lista;
+    unsigned int capacidade;
+    unsigned int tamanho;
+} lru;
+
+// resultados de lru_tocar
+#define LRU_FALTA 0
+#define LRU_ACERTO 1
+#define LRU_FALTA_COM_REMOCAO 2
+
 
 void init_list(list *mylist);
 
@@ -37,6 +94,26 @@ void mostrar_decrescente(list *myList);
 
 void liberar_memoria(list *myList);
 
+void liberar_pool(list *myList);
+
+void mostrar_estatisticas_pool(list *myList);
+
+int ativar_indice(list *myList);
+
+void desativar_indice(list *myList);
+
+void mover_para_inicio(list *myList, node *elemento);
+
+void lru_init(lru *cache, unsigned int capacidade);
+
+int lru_tocar(lru *cache, int value, int *removido);
+
+int lru_remover_cauda(lru *cache, int *removido);
+
+void lru_liberar(lru *cache);
+
+void simular_lru(unsigned int capacidade, int acessos, int faixa);
+
 int main(void)
 {
 
@@ -66,9 +143,13 @@ int main(void)
         printf("[5] Exibir em ordem crescente\n");
         printf("[6] Exibir em ordem decrescente\n");
         printf("[7] Localizar elemento\n");
+        printf("[8] %s índice de busca\n", lista_numeros->indice ? "Desativar" : "Ativar");
+        printf("[9] Simular cache LRU\n");
+        printf("[10] Estatísticas do pool de nós\n");
         printf("[0] Encerrar programa\n");
         printf("\nDigite sua escolha: ");
-        scanf("%d", &opcao);
+        if (scanf("%d", &opcao) != 1)
+            opcao = 0;
 
         // Processar escolha do usuário
         switch (opcao)
@@ -123,6 +204,38 @@ int main(void)
             }
             break;
 
+        case 8:
+            if (lista_numeros->indice)
+            {
+                desativar_indice(lista_numeros);
+                printf("Índice desativado.\n");
+            }
+            else if (ativar_indice(lista_numeros))
+            {
+                printf("Índice ativado: busca, inserção após elemento e remoção em O(1).\n");
+            }
+            else
+            {
+                printf("[ERRO] A lista tem valores repetidos; o índice exige valores únicos.\n");
+            }
+            break;
+
+        case 9:
+        {
+            int capacidade, acessos, faixa;
+            printf("Capacidade do cache, número de acessos e faixa dos valores: ");
+            scanf("%d %d %d", &capacidade, &acessos, &faixa);
+            if (capacidade > 0 && acessos >= 0 && faixa > 0)
+                simular_lru((unsigned int)capacidade, acessos, faixa);
+            else
+                printf("[ERRO] Valores inválidos.\n");
+            break;
+        }
+
+        case 10:
+            mostrar_estatisticas_pool(lista_numeros);
+            break;
+
         case 0:
             printf("\nFinalizando programa...\n");
             break;
@@ -133,7 +246,8 @@ int main(void)
     }
 
     // Liberar memória antes de encerrar
-    liberar_memoria(lista_numeros);
+    liberar_pool(lista_numeros);
+    free(lista_numeros);
     printf("Memória liberada com sucesso!\n");
 
     return 0;
@@ -144,13 +258,194 @@ void init_list(list *mylist)
 {
     mylist->cabeca = NULL;
     mylist->cauda = NULL;
+    mylist->indice = NULL;
+    mylist->tamanho = 0;
+    memset(&mylist->pool, 0, sizeof(pool_nos));
+}
+
+// entrega um nó do pool (NULL se faltar memória)
+static node *alocar_no(list *myList)
+{
+    pool_nos *pool = &myList->pool;
+    node *no;
+
+    if (pool->livres)
+    {
+        // 1. reaproveita um nó devolvido
+        no = pool->livres;
+        pool->livres = no->proximo;
+        pool->nos_reaproveitados++;
+    }
+    else
+    {
+        // 2. usa o próximo nó ainda não entregue do slab atual, alocando um slab novo se acabou
+        if (pool->slabs == NULL || pool->slabs->usados == pool->slabs->capacidade)
+        {
+            unsigned int capacidade = pool->slabs ? pool->slabs->capacidade * 2 : NOS_POR_SLAB_MIN;
+            if (capacidade > NOS_POR_SLAB_MAX)
+                capacidade = NOS_POR_SLAB_MAX;
+
+            slab *novo = (slab *)malloc(sizeof(slab) + capacidade * sizeof(node));
+            if (novo == NULL)
+                return NULL;
+            novo->capacidade = capacidade;
+            novo->usados = 0;
+            novo->proximo = pool->slabs;
+            pool->slabs = novo;
+            pool->slabs_alocados++;
+            pool->nos_em_slabs += capacidade;
+        }
+        no = &pool->slabs->nos[pool->slabs->usados++];
+    }
+    pool->nos_entregues++;
+    myList->tamanho++;
+    return no;
+}
+
+// devolve um nó ao pool (no lugar de free)
+static void devolver_no(list *myList, node *no)
+{
+    no->proximo = myList->pool.livres;
+    myList->pool.livres = no;
+    myList->pool.nos_devolvidos++;
+    myList->tamanho--;
+}
+
+// espalha os bits do valor (hash multiplicativo) e reduz à capacidade da tabela
+static unsigned int posicao_indice(indice *idx, int value)
+{
+    return ((unsigned int)value * 2654435761u) & (idx->capacidade - 1);
+}
+
+// devolve o nó com o valor, ou NULL
+static node *indice_buscar(indice *idx, int value)
+{
+    unsigned int pos = posicao_indice(idx, value);
+    while (idx->entradas[pos].no != NULL)
+    {
+        if (idx->entradas[pos].valor == value)
+            return idx->entradas[pos].no;
+        pos = (pos + 1) & (idx->capacidade - 1);
+    }
+    return NULL;
+}
+
+static void indice_inserir(indice *idx, int value, node *no);
+
+// dobra a tabela e reinsere as entradas
+static void indice_crescer(indice *idx)
+{
+    entrada_indice *antigas = idx->entradas;
+    unsigned int capacidade_antiga = idx->capacidade;
+
+    idx->capacidade *= 2;
+    idx->entradas = (entrada_indice *)calloc(idx->capacidade, sizeof(entrada_indice));
+    idx->quantidade = 0;
+    for (unsigned int i = 0; i < capacidade_antiga; i++)
+    {
+        if (antigas[i].no != NULL)
+            indice_inserir(idx, antigas[i].valor, antigas[i].no);
+    }
+    free(antigas);
+}
+
+// associa o valor ao nó (o valor não pode estar no índice)
+static void indice_inserir(indice *idx, int value, node *no)
+{
+    // mantém a ocupação abaixo de 70% para as sondagens continuarem curtas
+    if ((idx->quantidade + 1) * 10 > idx->capacidade * 7)
+        indice_crescer(idx);
+
+    unsigned int pos = posicao_indice(idx, value);
+    while (idx->entradas[pos].no != NULL)
+        pos = (pos + 1) & (idx->capacidade - 1);
+    idx->entradas[pos].valor = value;
+    idx->entradas[pos].no = no;
+    idx->quantidade++;
+}
+
+// tira o valor do índice
+// as entradas seguintes do mesmo agrupamento são puxadas para trás quando a posição original
+// delas não fica entre o buraco e elas, então a tabela não precisa de marcas de removido
+static void indice_remover(indice *idx, int value)
+{
+    unsigned int mascara = idx->capacidade - 1;
+    unsigned int pos = posicao_indice(idx, value);
+    while (idx->entradas[pos].no != NULL && idx->entradas[pos].valor != value)
+        pos = (pos + 1) & mascara;
+    if (idx->entradas[pos].no == NULL)
+        return;
+
+    unsigned int buraco = pos;
+    for (unsigned int atual = (buraco + 1) & mascara; idx->entradas[atual].no != NULL; atual = (atual + 1) & mascara)
+    {
+        unsigned int origem = posicao_indice(idx, idx->entradas[atual].valor);
+        // distância da origem até a posição atual e do buraco até a posição atual
+        if (((atual - origem) & mascara) >= ((atual - buraco) & mascara))
+        {
+            idx->entradas[buraco] = idx->entradas[atual];
+            buraco = atual;
+        }
+    }
+    idx->entradas[buraco].no = NULL;
+    idx->quantidade--;
+}
+
+// liga o índice e indexa os nós que já estão na lista; falha (e o índice fica desligado)
+// se a lista tiver valores repetidos
+int ativar_indice(list *myList)
+{
+    if (myList->indice)
+        return 1;
+
+    indice *idx = (indice *)malloc(sizeof(indice));
+    idx->capacidade = 16;
+    idx->quantidade = 0;
+    idx->entradas = (entrada_indice *)calloc(idx->capacidade, sizeof(entrada_indice));
+
+    for (node *ptr = myList->cabeca; ptr; ptr = ptr->proximo)
+    {
+        if (indice_buscar(idx, ptr->valor) != NULL)
+        {
+            free(idx->entradas);
+            free(idx);
+            return 0;
+        }
+        indice_inserir(idx, ptr->valor, ptr);
+    }
+    myList->indice = idx;
+    return 1;
+}
+
+void desativar_indice(list *myList)
+{
+    if (myList->indice)
+    {
+        free(myList->indice->entradas);
+        free(myList->indice);
+        myList->indice = NULL;
+    }
+}
+
+// com o índice ligado, um valor que já está na lista não é inserido de novo
+static int valor_repetido(list *myList, int value)
+{
+    if (myList->indice && indice_buscar(myList->indice, value) != NULL)
+    {
+        printf("\nvalor %d já está na lista\n", value);
+        return 1;
+    }
+    return 0;
 }
 
 // adiciona valor ao inicio da lista
 void inserir_inicio(list *myList, int value)
 {
+    if (valor_repetido(myList, value))
+        return;
+
     // Aloca memória para o novo nó
-    node *novo_elemento = (node *)malloc(sizeof(node));
+    node *novo_elemento = alocar_no(myList);
 
     if (novo_elemento != NULL)
     {
@@ -173,6 +468,9 @@ void inserir_inicio(list *myList, int value)
 
         // Atualiza a cabeça da lista para o novo elemento
         myList->cabeca = novo_elemento;
+
+        if (myList->indice)
+            indice_inserir(myList->indice, value, novo_elemento);
     }
     else
     {
@@ -182,8 +480,11 @@ void inserir_inicio(list *myList, int value)
 
 void inserir_fim(list *myList, int value)
 {
+    if (valor_repetido(myList, value))
+        return;
+
     // Aloca memória para o novo elemento
-    node *novo_elemento = (node *)malloc(sizeof(node));
+    node *novo_elemento = alocar_no(myList);
 
     if (novo_elemento != NULL)
     {
@@ -207,6 +508,9 @@ void inserir_fim(list *myList, int value)
 
         // Atualiza a cauda da lista
         myList->cauda = novo_elemento;
+
+        if (myList->indice)
+            indice_inserir(myList->indice, value, novo_elemento);
     }
     else
     {
@@ -223,6 +527,12 @@ node *buscar(list *myList, int value)
         return NULL;
     }
 
+    // Com o índice, a busca é uma consulta à tabela
+    if (myList->indice)
+    {
+        return indice_buscar(myList->indice, value);
+    }
+
     // Percorre a lista buscando o elemento
     node *atual = myList->cabeca;
 
@@ -250,17 +560,17 @@ void inserir_meio(list *myList, int value, int ant)
     // 1.1 se ele existe
     if (novoAnterior)
     {
-        if (novoAnterior == myList->cabeca)
+        if (valor_repetido(myList, value))
         {
-            inserir_inicio(myList, value);
+            return;
         }
-        else if (novoAnterior == myList->cauda)
+        if (novoAnterior == myList->cauda)
         {
             inserir_fim(myList, value);
         }
         else
         {
-            node *novo = malloc(sizeof(node));
+            node *novo = alocar_no(myList);
             if (novo)
             {   
                 // 2.3 configurar novo node
@@ -272,6 +582,9 @@ void inserir_meio(list *myList, int value, int ant)
                 // 2.5 nó anterior->proximo agora aponta para o novo node
                 novoAnterior->proximo = novo;
 
+                if (myList->indice)
+                    indice_inserir(myList->indice, value, novo);
+
             }
             else
             {
@@ -291,6 +604,8 @@ void remover_inicio(list *myList, int value)
     if (myList->cabeca)
     {   
         node *remover = myList->cabeca;
+        if (myList->indice)
+            indice_remover(myList->indice, remover->valor);
         // se há apenas 1 elemento na lista
         if (myList->cabeca == myList->cauda)
         {
@@ -304,7 +619,7 @@ void remover_inicio(list *myList, int value)
             remover->proximo->anterior = NULL;
             myList->cabeca = remover->proximo;
         }
-        free(remover);
+        devolver_no(myList, remover);
         
     }
     else
@@ -318,6 +633,8 @@ void remover_final(list *myList, int value)
     if (myList->cabeca)
     {   
         node *remover = myList->cauda;
+        if (myList->indice)
+            indice_remover(myList->indice, remover->valor);
         // se há apenas 1 elemento na lista
         if (myList->cabeca == myList->cauda)
         {
@@ -331,7 +648,7 @@ void remover_final(list *myList, int value)
             remover->anterior->proximo = NULL;
             myList->cauda = remover->anterior;
         }
-        free(remover);
+        devolver_no(myList, remover);
         
     }
     else
@@ -359,7 +676,9 @@ void remover_elemento(list *myList, int value)
         {
             remover->anterior->proximo = remover->proximo;
             remover->proximo->anterior = remover->anterior;
-            free(remover);
+            if (myList->indice)
+                indice_remover(myList->indice, value);
+            devolver_no(myList, remover);
         }
     }
     // 1.2 se o elemento não for encontrado
@@ -409,20 +728,151 @@ void mostrar_decrescente(list *myList)
     }
 }
 
+// esvazia a lista em O(1): a cadeia inteira de nós já está encadeada por 'proximo',
+// então basta pendurá-la na frente da lista de livres do pool.
+// se o índice está ligado ele continua ligado, só que vazio (a tabela é zerada, sem ser liberada)
 void liberar_memoria(list *myList)
 {
-    node *ptr = myList->cabeca;
-    node *prox = ptr;
+    if (myList->cabeca)
+    {
+        myList->cauda->proximo = myList->pool.livres;
+        myList->pool.livres = myList->cabeca;
+        myList->pool.nos_devolvidos += myList->tamanho;
+    }
+
+    myList->cabeca = NULL;
+    myList->cauda = NULL;
+    myList->tamanho = 0;
+    if (myList->indice)
+    {
+        memset(myList->indice->entradas, 0, myList->indice->capacidade * sizeof(entrada_indice));
+        myList->indice->quantidade = 0;
+    }
+}
+
+// esvazia a lista e devolve ao sistema a memória de todos os slabs do pool e do índice
+void liberar_pool(list *myList)
+{
+    liberar_memoria(myList);
+    desativar_indice(myList);
 
-    while(ptr && prox)
+    slab *ptr = myList->pool.slabs;
+    while (ptr)
     {
-        prox = ptr->proximo;
+        slab *prox = ptr->proximo;
         free(ptr);
         ptr = prox;
     }
+    memset(&myList->pool, 0, sizeof(pool_nos));
+}
 
-    myList->cabeca = NULL;
-    myList->cauda = NULL;
+void mostrar_estatisticas_pool(list *myList)
+{
+    pool_nos *pool = &myList->pool;
+    printf("Nós na lista: %lu\n", myList->tamanho);
+    printf("Slabs alocados: %lu (%lu nós, %lu bytes)\n", pool->slabs_alocados, pool->nos_em_slabs,
+           (unsigned long)(pool->slabs_alocados * sizeof(slab) + pool->nos_em_slabs * sizeof(node)));
+    printf("Nós entregues: %lu (%lu reaproveitados da lista de livres)\n", pool->nos_entregues,
+           pool->nos_reaproveitados);
+    printf("Nós devolvidos: %lu\n", pool->nos_devolvidos);
+}
+
+// move um nó da lista para o início, só trocando as ligações (o índice não muda)
+void mover_para_inicio(list *myList, node *elemento)
+{
+    if (elemento == myList->cabeca)
+        return;
+
+    // desliga o nó da posição atual (ele não é a cabeça, então tem anterior)
+    elemento->anterior->proximo = elemento->proximo;
+    if (elemento->proximo)
+        elemento->proximo->anterior = elemento->anterior;
+    else
+        myList->cauda = elemento->anterior;
+
+    // religa antes da cabeça
+    elemento->anterior = NULL;
+    elemento->proximo = myList->cabeca;
+    myList->cabeca->anterior = elemento;
+    myList->cabeca = elemento;
+}
+
+// cria um cache LRU vazio com a lista indexada
+void lru_init(lru *cache, unsigned int capacidade)
+{
+    init_list(&cache->lista);
+    ativar_indice(&cache->lista);
+    cache->capacidade = capacidade;
+    cache->tamanho = 0;
+}
+
+// tira o valor menos recente (a cauda); devolve 0 se o cache estiver vazio
+int lru_remover_cauda(lru *cache, int *removido)
+{
+    if (cache->lista.cauda == NULL)
+        return 0;
+
+    *removido = cache->lista.cauda->valor;
+    remover_final(&cache->lista, *removido);
+    cache->tamanho--;
+    return 1;
+}
+
+// registra um acesso ao valor, em O(1)
+// acerto: o nó vai para o início; falta: o valor entra no início e, se o cache passou da
+// capacidade, o menos recente sai (e vai para *removido)
+int lru_tocar(lru *cache, int value, int *removido)
+{
+    node *elemento = cache->lista.cabeca ? indice_buscar(cache->lista.indice, value) : NULL;
+
+    if (elemento)
+    {
+        mover_para_inicio(&cache->lista, elemento);
+        return LRU_ACERTO;
+    }
+
+    inserir_inicio(&cache->lista, value);
+    cache->tamanho++;
+    if (cache->tamanho > cache->capacidade && lru_remover_cauda(cache, removido))
+        return LRU_FALTA_COM_REMOCAO;
+    return LRU_FALTA;
+}
+
+void lru_liberar(lru *cache)
+{
+    liberar_pool(&cache->lista);
+    cache->tamanho = 0;
+}
+
+// simula acessos aleatórios a um cache LRU e mostra a taxa de acertos
+void simular_lru(unsigned int capacidade, int acessos, int faixa)
+{
+    lru cache;
+    int acertos = 0, remocoes = 0, removido;
+
+    lru_init(&cache, capacidade);
+    srand(42);
+    clock_t inicio = clock();
+    for (int i = 0; i < acessos; i++)
+    {
+        // metade dos acessos cai no primeiro décimo da faixa (valores "quentes")
+        int value = rand() % 2 ? rand() % (faixa / 10 + 1) : rand() % faixa;
+        int resultado = lru_tocar(&cache, value, &removido);
+        if (resultado == LRU_ACERTO)
+            acertos++;
+        else if (resultado == LRU_FALTA_COM_REMOCAO)
+            remocoes++;
+    }
+    double segundos = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+
+    printf("%d acessos: %d acertos (%.1f%%), %d faltas, %d remoções, %.3f s\n", acessos, acertos,
+           acessos ? 100.0 * acertos / acessos : 0.0, acessos - acertos, remocoes, segundos);
+    if (cache.tamanho <= 20)
+    {
+        printf("Conteúdo do cache (mais recente primeiro): ");
+        mostrar_crescente(&cache.lista);
+    }
+    lru_liberar(&cache);
 }
 
 
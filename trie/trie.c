@@ -3,272 +3,2862 @@
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #define NUM_CHARS 256
 
+// Tipos de nó adaptativos (no estilo ART): o nó começa pequeno e cresce conforme ganha filhos.
+// NO4 e NO16 guardam os caracteres em ordem num vetor pequeno,
+// NO48 usa um índice de 256 bytes apontando para 48 posições de filhos
+// e NO256 é o vetor direto de 256 ponteiros (o layout antigo), usado só quando o nó é realmente denso.
+//
+// A árvore também é comprimida (radix/Patricia): cada aresta guarda uma sequência de bytes ('rotulo')
+// em vez de um único caractere, então uma cadeia de nós com um filho só vira um único nó.
+// O primeiro byte do rótulo é o caractere pelo qual o pai indexa o filho; a raiz tem rótulo vazio.
+#define NO4 0
+#define NO16 1
+#define NO48 2
+#define NO256 3
+
+// Quantidade de palavras mais frequentes guardadas no cache de autocompletar de cada nó
+#define TOPK 8
+
+struct ArvoreTrie;
+
+// Cache opcional das TOPK palavras mais frequentes da subárvore de um nó,
+// em ordem decrescente de frequência. Guarda os nós de término; a palavra é
+// reconstruída subindo pelos ponteiros 'pai'.
+typedef struct CacheTopK
+{
+    int quantidade;
+    struct ArvoreTrie *nos[TOPK];
+} CacheTopK;
+
 typedef struct ArvoreTrie
 {
-    struct ArvoreTrie *filhos[NUM_CHARS];
-    bool termino;
+    unsigned char tipo;         // NO4, NO16, NO48 ou NO256
+    unsigned short num_filhos;  // quantidade de filhos ocupados
+    uint64_t mapa_filhos[4];    // bitmap de 256 bits: bit c ligado = existe filho pelo caractere c
+    unsigned int termino;       // ocorrências da palavra terminada aqui (0 = não é fim de palavra); peso no autocompletar
+    int tam_rotulo;             // quantidade de bytes da aresta que chega neste nó
+    unsigned char *rotulo;      // bytes da aresta (NULL na raiz)
+    unsigned char *chaves;      // NO4/NO16: caracteres em ordem; NO48: índice (0 = vazio, i + 1 = filhos[i]); NO256: NULL
+    struct ArvoreTrie **filhos; // NO4: 4, NO16: 16, NO48: 48 e NO256: 256 posições
+    struct ArvoreTrie *pai;     // NULL na raiz
+    CacheTopK *topk;            // NULL quando o cache de autocompletar não está ativo
+    struct ArenaTrie *arena;    // arena da árvore a que o nó pertence (cabe no mesmo bloco de 96 bytes)
 } ArvoreTrie;
 
-// Cria um novo nó para a árvore Trie.
-// Aloca memória para a estrutura ArvoreTrie.
-// Inicializa todos os ponteiros dos filhos como NULL.
-// Define o marcador de término de palavra ('termino') como falso.
-// Retorna o ponteiro para o nó recém-criado.
-ArvoreTrie *CriaArvore()
+// Capacidade de filhos de cada tipo de nó
+static const int capacidade_tipo[] = {4, 16, 48, NUM_CHARS};
+
+// Operações no bitmap de filhos (palavra c / 64, bit c % 64)
+bool TemBitFilho(ArvoreTrie *arv, unsigned char c)
+{
+    return (arv->mapa_filhos[c >> 6] >> (c & 63)) & 1;
+}
+
+void LigaBitFilho(ArvoreTrie *arv, unsigned char c)
+{
+    arv->mapa_filhos[c >> 6] |= (uint64_t)1 << (c & 63);
+}
+
+void DesligaBitFilho(ArvoreTrie *arv, unsigned char c)
+{
+    arv->mapa_filhos[c >> 6] &= ~((uint64_t)1 << (c & 63));
+}
+
+// Retorna o menor caractere >= 'inicio' que tem filho, ou NUM_CHARS se não houver.
+// Usa ctz (contagem de zeros à direita) para pular direto para o próximo bit ligado.
+int ProximoBitFilho(ArvoreTrie *arv, int inicio)
+{
+    if (inicio >= NUM_CHARS)
+        return NUM_CHARS;
+
+    int palavra = inicio >> 6;
+    uint64_t bits = arv->mapa_filhos[palavra] & (~(uint64_t)0 << (inicio & 63));
+    while (bits == 0)
+    {
+        if (++palavra == 4)
+            return NUM_CHARS;
+        bits = arv->mapa_filhos[palavra];
+    }
+    return (palavra << 6) + __builtin_ctzll(bits);
+}
+
+// ---------------------------------------------------------------------------
+// Alocador em blocos (slabs) para os nós da Trie.
+// Toda a memória da árvore (cabeçalhos, vetores de filhos, rótulos e caches) sai de slabs grandes,
+// divididos em classes de tamanho. Blocos liberados vão para a lista livre da classe e são
+// reaproveitados nas próximas alocações, sem voltar para o malloc. Liberar a árvore inteira é
+// devolver os slabs (ArenaDestroi), sem visitar nó por nó.
+// Cada árvore tem a sua arena, criada junto com a raiz: todo nó aponta para ela, então as funções
+// que alocam tiram a arena do nó que já têm em mãos. Liberar uma árvore não afeta as outras.
+// ---------------------------------------------------------------------------
+
+#define TAM_SLAB (64 * 1024)
+#define NUM_CLASSES 20        // múltiplos de 16 até 256 bytes (16 classes), depois 512, 1024, 2048 e 4096
+#define MAIOR_CLASSE 4096
+
+typedef struct BlocoLivre
+{
+    struct BlocoLivre *proximo;
+} BlocoLivre;
+
+// Cabeçalho dos slabs e dos blocos maiores que a maior classe (alocados à parte)
+typedef struct Slab
+{
+    struct Slab *anterior;
+    struct Slab *proximo;
+} Slab;
+
+typedef struct ArenaTrie
+{
+    BlocoLivre *livres[NUM_CLASSES]; // listas livres por classe
+    unsigned char *atual;            // área ainda não usada do slab atual
+    size_t restante;
+    Slab *slabs;
+    Slab *grandes;
+
+    // Contadores para monitoramento
+    long alocacoes;
+    long liberacoes;
+    long reutilizacoes; // alocações atendidas pela lista livre
+    long num_slabs;
+    long num_grandes;
+    long bytes_em_uso;
+    long bytes_reservados;
+} ArenaTrie;
+
+// Cria uma arena vazia (sem slabs): o primeiro slab só é obtido na primeira alocação.
+ArenaTrie *CriaArena()
+{
+    return (ArenaTrie *)calloc(1, sizeof(ArenaTrie));
+}
+
+int ClasseDoTamanho(size_t tamanho)
+{
+    if (tamanho <= 256)
+        return (tamanho + 15) / 16 - 1;
+    if (tamanho <= 512)
+        return 16;
+    if (tamanho <= 1024)
+        return 17;
+    if (tamanho <= 2048)
+        return 18;
+    if (tamanho <= MAIOR_CLASSE)
+        return 19;
+    return -1;
+}
+
+size_t TamanhoDaClasse(int classe)
+{
+    if (classe < 16)
+        return (classe + 1) * 16;
+    return (size_t)512 << (classe - 16);
+}
+
+// Aloca 'tamanho' bytes da arena. Blocos novos vêm de slabs obtidos com calloc,
+// então já chegam zerados; com 'zerar', só os blocos reaproveitados precisam de memset.
+void *ArenaAloca(ArenaTrie *arena, size_t tamanho, bool zerar)
+{
+    if (tamanho == 0)
+        return NULL;
+
+    arena->alocacoes++;
+    arena->bytes_em_uso += tamanho;
+
+    int classe = ClasseDoTamanho(tamanho);
+    if (classe < 0)
+    {
+        // Maior que a maior classe: bloco próprio, ligado na lista de grandes
+        Slab *grande = (Slab *)calloc(1, sizeof(Slab) + tamanho);
+        grande->anterior = NULL;
+        grande->proximo = arena->grandes;
+        if (arena->grandes != NULL)
+            arena->grandes->anterior = grande;
+        arena->grandes = grande;
+        arena->num_grandes++;
+        arena->bytes_reservados += sizeof(Slab) + tamanho;
+        return grande + 1;
+    }
+
+    if (arena->livres[classe] != NULL)
+    {
+        BlocoLivre *bloco = arena->livres[classe];
+        arena->livres[classe] = bloco->proximo;
+        arena->reutilizacoes++;
+        if (zerar)
+            memset(bloco, 0, TamanhoDaClasse(classe));
+        return bloco;
+    }
+
+    size_t tamanho_classe = TamanhoDaClasse(classe);
+    if (arena->restante < tamanho_classe)
+    {
+        Slab *slab = (Slab *)calloc(1, TAM_SLAB);
+        slab->anterior = NULL;
+        slab->proximo = arena->slabs;
+        arena->slabs = slab;
+        arena->atual = (unsigned char *)slab + 16; // mantém os blocos alinhados em 16 bytes
+        arena->restante = TAM_SLAB - 16;
+        arena->num_slabs++;
+        arena->bytes_reservados += TAM_SLAB;
+    }
+
+    void *bloco = arena->atual;
+    arena->atual += tamanho_classe;
+    arena->restante -= tamanho_classe;
+    return bloco;
+}
+
+// Devolve um bloco para a arena-> O tamanho deve ser o mesmo usado na alocação.
+void ArenaLibera(ArenaTrie *arena, void *ptr, size_t tamanho)
+{
+    if (ptr == NULL)
+        return;
+
+    arena->liberacoes++;
+    arena->bytes_em_uso -= tamanho;
+
+    int classe = ClasseDoTamanho(tamanho);
+    if (classe < 0)
+    {
+        Slab *grande = (Slab *)ptr - 1;
+        if (grande->anterior != NULL)
+            grande->anterior->proximo = grande->proximo;
+        else
+            arena->grandes = grande->proximo;
+        if (grande->proximo != NULL)
+            grande->proximo->anterior = grande->anterior;
+        arena->num_grandes--;
+        arena->bytes_reservados -= sizeof(Slab) + tamanho;
+        free(grande);
+        return;
+    }
+
+    BlocoLivre *bloco = (BlocoLivre *)ptr;
+    bloco->proximo = arena->livres[classe];
+    arena->livres[classe] = bloco;
+}
+
+// Libera de uma vez toda a memória da arena: custo proporcional ao número de slabs
+// (cada um com centenas de nós), não ao número de nós. A estrutura da arena também é liberada.
+void ArenaDestroi(ArenaTrie *arena)
+{
+    for (Slab *slab = arena->slabs; slab != NULL;)
+    {
+        Slab *proximo = slab->proximo;
+        free(slab);
+        slab = proximo;
+    }
+    for (Slab *grande = arena->grandes; grande != NULL;)
+    {
+        Slab *proximo = grande->proximo;
+        free(grande);
+        grande = proximo;
+    }
+
+    free(arena);
+}
+
+void MostraEstatisticasAlocador(ArvoreTrie *arv)
 {
-    ArvoreTrie *arv = (ArvoreTrie *)malloc(sizeof(ArvoreTrie));
-    for (int i = 0; i < NUM_CHARS; i++)
+    if (arv == NULL)
     {
-        arv->filhos[i] = NULL;
+        printf("Alocador: arvore vazia, nenhuma memoria reservada\n");
+        return;
     }
-    arv->termino = false;
+    ArenaTrie *arena = arv->arena;
+    printf("Alocador: %ld alocacoes, %ld liberacoes, %ld reaproveitadas da lista livre\n",
+           arena->alocacoes, arena->liberacoes, arena->reutilizacoes);
+    printf("Slabs: %ld de %d bytes, %ld blocos grandes; %ld bytes em uso de %ld reservados\n",
+           arena->num_slabs, TAM_SLAB, arena->num_grandes, arena->bytes_em_uso, arena->bytes_reservados);
+}
+
+// Cria um novo nó para a árvore Trie, alocado da arena 'arena' (CriaArena() para uma árvore nova).
+// Aloca apenas o cabeçalho do nó: os vetores de filhos
+// só são alocados quando o primeiro filho é inserido (folhas não gastam nada com eles).
+// Zera o contador de término de palavra ('termino').
+// Retorna o ponteiro para o nó recém-criado.
+ArvoreTrie *CriaArvore(ArenaTrie *arena)
+{
+    ArvoreTrie *arv = (ArvoreTrie *)ArenaAloca(arena, sizeof(ArvoreTrie), false);
+    arv->arena = arena;
+    arv->tipo = NO4;
+    arv->num_filhos = 0;
+    memset(arv->mapa_filhos, 0, sizeof(arv->mapa_filhos));
+    arv->termino = 0;
+    arv->tam_rotulo = 0;
+    arv->rotulo = NULL;
+    arv->chaves = NULL;
+    arv->filhos = NULL;
+    arv->pai = NULL;
+    arv->topk = NULL;
+    return arv;
+}
+
+// Cria um nó cuja aresta de entrada é a sequência 'rotulo' de 'tamanho' bytes.
+ArvoreTrie *CriaNoComRotulo(ArenaTrie *arena, const unsigned char *rotulo, int tamanho)
+{
+    ArvoreTrie *arv = CriaArvore(arena);
+    arv->tam_rotulo = tamanho;
+    arv->rotulo = (unsigned char *)ArenaAloca(arena, tamanho, false);
+    memcpy(arv->rotulo, rotulo, tamanho);
     return arv;
 }
 
-// Insere uma string (palavra) na árvore Trie.
+// Aloca os vetores de um tipo de nó, sem filhos.
+void AlocaVetoresFilhos(ArvoreTrie *arv, unsigned char tipo)
+{
+    arv->tipo = tipo;
+    arv->filhos = (ArvoreTrie **)ArenaAloca(arv->arena, capacidade_tipo[tipo] * sizeof(ArvoreTrie *), true);
+    if (tipo == NO48)
+        arv->chaves = (unsigned char *)ArenaAloca(arv->arena, NUM_CHARS, true);
+    else if (tipo == NO256)
+        arv->chaves = NULL;
+    else
+        arv->chaves = (unsigned char *)ArenaAloca(arv->arena, capacidade_tipo[tipo], false);
+}
+
+// Tamanho do vetor 'chaves' de cada tipo de nó
+size_t TamanhoChaves(unsigned char tipo)
+{
+    if (tipo == NO48)
+        return NUM_CHARS;
+    if (tipo == NO256)
+        return 0;
+    return capacidade_tipo[tipo];
+}
+
+// Devolve os vetores de filhos para a arena.
+void LiberaVetoresFilhos(ArvoreTrie *arv)
+{
+    if (arv->filhos == NULL)
+        return;
+    ArenaLibera(arv->arena, arv->chaves, TamanhoChaves(arv->tipo));
+    ArenaLibera(arv->arena, arv->filhos, capacidade_tipo[arv->tipo] * sizeof(ArvoreTrie *));
+    arv->chaves = NULL;
+    arv->filhos = NULL;
+}
+
+// Retorna o filho ligado pelo caractere 'c', ou NULL se ele não existir.
+ArvoreTrie *ObtemFilho(ArvoreTrie *arv, unsigned char c)
+{
+    // O bitmap responde a ausência em O(1), sem olhar os vetores
+    if (!TemBitFilho(arv, c))
+        return NULL;
+
+    switch (arv->tipo)
+    {
+    case NO4:
+    case NO16:
+        // Vetor ordenado e pequeno: a busca linear cabe em uma linha de cache
+        for (int i = 0; i < arv->num_filhos && arv->chaves[i] <= c; i++)
+        {
+            if (arv->chaves[i] == c)
+                return arv->filhos[i];
+        }
+        return NULL;
+    case NO48:
+        return arv->filhos[arv->chaves[c] - 1];
+    default:
+        return arv->filhos[c];
+    }
+}
+
+// Percorre os filhos em ordem crescente de caractere.
+// 'pos' deve começar em 0 e é avançado a cada chamada.
+// Retorna false quando não há mais filhos; caso contrário preenche 'c' e 'filho'.
+bool ProximoFilho(ArvoreTrie *arv, int *pos, unsigned char *c, ArvoreTrie **filho)
+{
+    if (arv->tipo == NO4 || arv->tipo == NO16)
+    {
+        if (*pos >= arv->num_filhos)
+            return false;
+        *c = arv->chaves[*pos];
+        *filho = arv->filhos[*pos];
+        (*pos)++;
+        return true;
+    }
+
+    // NO48/NO256: só visita os caracteres com bit ligado, em vez de testar as 256 posições
+    int proximo = ProximoBitFilho(arv, *pos);
+    if (proximo == NUM_CHARS)
+    {
+        *pos = NUM_CHARS;
+        return false;
+    }
+    *c = (unsigned char)proximo;
+    *filho = ObtemFilho(arv, *c);
+    *pos = proximo + 1;
+    return true;
+}
+
+// Converte o nó para outro tipo (maior ou menor), copiando os filhos existentes.
+void MudaTipoNo(ArvoreTrie *arv, unsigned char novo_tipo)
+{
+    unsigned char chaves_antigas[NUM_CHARS];
+    ArvoreTrie *filhos_antigos[NUM_CHARS];
+    int quantidade = 0;
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+
+    while (ProximoFilho(arv, &pos, &c, &filho))
+    {
+        chaves_antigas[quantidade] = c;
+        filhos_antigos[quantidade] = filho;
+        quantidade++;
+    }
+
+    LiberaVetoresFilhos(arv);
+    AlocaVetoresFilhos(arv, novo_tipo);
+
+    for (int i = 0; i < quantidade; i++)
+    {
+        if (novo_tipo == NO4 || novo_tipo == NO16)
+        {
+            arv->chaves[i] = chaves_antigas[i];
+            arv->filhos[i] = filhos_antigos[i];
+        }
+        else if (novo_tipo == NO48)
+        {
+            arv->chaves[chaves_antigas[i]] = i + 1;
+            arv->filhos[i] = filhos_antigos[i];
+        }
+        else
+        {
+            arv->filhos[chaves_antigas[i]] = filhos_antigos[i];
+        }
+    }
+}
+
+// Liga 'filho' ao nó pelo caractere 'c' (que ainda não pode existir no nó).
+// Se o nó estiver cheio, ele cresce para o próximo tipo.
+void AdicionaFilho(ArvoreTrie *arv, unsigned char c, ArvoreTrie *filho)
+{
+    if (arv->filhos == NULL)
+        AlocaVetoresFilhos(arv, NO4);
+    else if (arv->num_filhos == capacidade_tipo[arv->tipo])
+        MudaTipoNo(arv, arv->tipo + 1);
+
+    if (arv->tipo == NO4 || arv->tipo == NO16)
+    {
+        // Mantém o vetor ordenado: desloca os maiores uma posição para a direita
+        int i = arv->num_filhos;
+        while (i > 0 && arv->chaves[i - 1] > c)
+        {
+            arv->chaves[i] = arv->chaves[i - 1];
+            arv->filhos[i] = arv->filhos[i - 1];
+            i--;
+        }
+        arv->chaves[i] = c;
+        arv->filhos[i] = filho;
+    }
+    else if (arv->tipo == NO48)
+    {
+        // Procura uma posição livre no vetor de 48 filhos
+        int i = 0;
+        while (arv->filhos[i] != NULL)
+            i++;
+        arv->filhos[i] = filho;
+        arv->chaves[c] = i + 1;
+    }
+    else
+    {
+        arv->filhos[c] = filho;
+    }
+    LigaBitFilho(arv, c);
+    arv->num_filhos++;
+    filho->pai = arv;
+}
+
+// Desliga o filho do caractere 'c'.
+// Quando o nó fica bem abaixo da capacidade do tipo menor, ele encolhe
+// (com folga, para não ficar alternando entre tipos a cada inserção/remoção).
+void RemoveFilho(ArvoreTrie *arv, unsigned char c)
+{
+    if (!TemBitFilho(arv, c))
+        return;
+
+    if (arv->tipo == NO4 || arv->tipo == NO16)
+    {
+        int i = 0;
+        while (arv->chaves[i] != c)
+            i++;
+        for (; i < arv->num_filhos - 1; i++)
+        {
+            arv->chaves[i] = arv->chaves[i + 1];
+            arv->filhos[i] = arv->filhos[i + 1];
+        }
+    }
+    else if (arv->tipo == NO48)
+    {
+        arv->filhos[arv->chaves[c] - 1] = NULL;
+        arv->chaves[c] = 0;
+    }
+    else
+    {
+        arv->filhos[c] = NULL;
+    }
+    DesligaBitFilho(arv, c);
+    arv->num_filhos--;
+
+    if (arv->num_filhos == 0)
+    {
+        // Virou folha: devolve os vetores
+        LiberaVetoresFilhos(arv);
+        arv->tipo = NO4;
+    }
+    else if (arv->tipo > NO4 && arv->num_filhos <= capacidade_tipo[arv->tipo - 1] * 3 / 4)
+    {
+        MudaTipoNo(arv, arv->tipo - 1);
+    }
+}
+
+// Troca o filho do caractere 'c' (que já existe) por 'novo'.
+void SubstituiFilho(ArvoreTrie *arv, unsigned char c, ArvoreTrie *novo)
+{
+    if (arv->tipo == NO4 || arv->tipo == NO16)
+    {
+        for (int i = 0; i < arv->num_filhos; i++)
+        {
+            if (arv->chaves[i] == c)
+            {
+                arv->filhos[i] = novo;
+                novo->pai = arv;
+                return;
+            }
+        }
+    }
+    else if (arv->tipo == NO48)
+        arv->filhos[arv->chaves[c] - 1] = novo;
+    else
+        arv->filhos[c] = novo;
+    novo->pai = arv;
+}
+
+// Quantidade de bytes iniciais em comum entre o rótulo e o texto restante.
+int TamanhoComum(const unsigned char *rotulo, int tam_rotulo, const unsigned char *texto, int tam_texto)
+{
+    int i = 0;
+    while (i < tam_rotulo && i < tam_texto && rotulo[i] == texto[i])
+        i++;
+    return i;
+}
+
+// Posiciona 'no' no cache de 'arv' depois que a frequência dele aumentou:
+// se já está no cache, sobe até a posição certa; senão entra no lugar do último se tiver frequência maior.
+void AtualizaCacheTopK(ArvoreTrie *arv, ArvoreTrie *no)
+{
+    CacheTopK *cache = arv->topk;
+    int i = 0;
+    while (i < cache->quantidade && cache->nos[i] != no)
+        i++;
+
+    if (i == cache->quantidade)
+    {
+        if (cache->quantidade < TOPK)
+            cache->quantidade++;
+        else if (cache->nos[TOPK - 1]->termino >= no->termino)
+            return;
+        i = cache->quantidade - 1;
+        cache->nos[i] = no;
+    }
+
+    while (i > 0 && cache->nos[i - 1]->termino < no->termino)
+    {
+        cache->nos[i] = cache->nos[i - 1];
+        cache->nos[i - 1] = no;
+        i--;
+    }
+}
+
+// Insere 'no' numa lista de melhores (ordem decrescente de frequência, no máximo 'limite' itens).
+void InsereEntreMelhores(ArvoreTrie **melhores, int *quantidade, int limite, ArvoreTrie *no)
+{
+    int i = *quantidade;
+    if (i == limite)
+    {
+        if (melhores[limite - 1]->termino >= no->termino)
+            return;
+        i--;
+    }
+    else
+    {
+        (*quantidade)++;
+    }
+    while (i > 0 && melhores[i - 1]->termino < no->termino)
+    {
+        melhores[i] = melhores[i - 1];
+        i--;
+    }
+    melhores[i] = no;
+}
+
+// Recalcula o cache de um nó a partir da própria palavra e dos caches dos filhos
+// (usado quando uma palavra sai da subárvore; os caches dos filhos já devem estar corretos).
+void RecalculaCacheTopK(ArvoreTrie *arv)
+{
+    CacheTopK *cache = arv->topk;
+    cache->quantidade = 0;
+    if (arv->termino)
+        InsereEntreMelhores(cache->nos, &cache->quantidade, TOPK, arv);
+
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(arv, &pos, &c, &filho))
+    {
+        for (int i = 0; i < filho->topk->quantidade; i++)
+            InsereEntreMelhores(cache->nos, &cache->quantidade, TOPK, filho->topk->nos[i]);
+    }
+}
+
+// Cria o cache de um nó novo quando o cache está ativo na árvore.
+void CriaCacheTopK(ArvoreTrie *arv)
+{
+    arv->topk = (CacheTopK *)ArenaAloca(arv->arena, sizeof(CacheTopK), false);
+    arv->topk->quantidade = 0;
+}
+
+// A frequência de 'no' aumentou: atualiza o cache dele e de todos os ancestrais.
+void PropagaFrequencia(ArvoreTrie *no)
+{
+    for (ArvoreTrie *atual = no; atual != NULL && atual->topk != NULL; atual = atual->pai)
+        AtualizaCacheTopK(atual, no);
+}
+
+// Divide a aresta que chega em 'filho' depois de 'posicao' bytes.
+// Cria um nó intermediário com o começo do rótulo, que passa a ser o filho de 'pai',
+// e 'filho' fica abaixo dele com o restante do rótulo. Retorna o nó intermediário.
+ArvoreTrie *DivideAresta(ArvoreTrie *pai, ArvoreTrie *filho, int posicao)
+{
+    ArvoreTrie *meio = CriaNoComRotulo(filho->arena, filho->rotulo, posicao);
+    SubstituiFilho(pai, filho->rotulo[0], meio);
+
+    // O rótulo do filho encolhe: vai para um bloco do tamanho certo (a arena libera pelo tamanho)
+    unsigned char *rotulo = (unsigned char *)ArenaAloca(filho->arena, filho->tam_rotulo - posicao, false);
+    memcpy(rotulo, filho->rotulo + posicao, filho->tam_rotulo - posicao);
+    ArenaLibera(filho->arena, filho->rotulo, filho->tam_rotulo);
+    filho->rotulo = rotulo;
+    filho->tam_rotulo -= posicao;
+    AdicionaFilho(meio, filho->rotulo[0], filho);
+
+    // A subárvore do nó intermediário é a mesma do filho: o cache é copiado
+    if (filho->topk != NULL)
+    {
+        CriaCacheTopK(meio);
+        *meio->topk = *filho->topk;
+    }
+    return meio;
+}
+
+// Localiza o nó da sequência de bytes 'caracter' (de tamanho 'comprimento'), criando o caminho se preciso.
+// Se a árvore estiver vazia, cria o nó raiz (com uma arena nova, só desta árvore).
+// Percorre a árvore aresta a aresta, comparando o rótulo de cada aresta com o trecho da string.
+// Se não existir aresta para o próximo caractere, cria um único nó com todo o resto da string como rótulo.
+// Se a string divergir no meio de um rótulo (ou terminar no meio dele), a aresta é dividida em duas.
+// Não mexe no contador 'termino' do nó retornado (continua 0 se a palavra é nova).
+ArvoreTrie *LocalizaOuCria(ArvoreTrie **arv, const unsigned char *caracter, int comprimento)
+{
+    if (*arv == NULL)
+    {
+        *arv = CriaArvore(CriaArena());
+    }
+
+    ArvoreTrie *tmp = *arv;
+    int i = 0;
+
+    while (i < comprimento)
+    {
+        ArvoreTrie *filho = ObtemFilho(tmp, caracter[i]);
+        if (filho == NULL)
+        {
+            // Nenhuma palavra segue por aqui: o resto da string vira o rótulo de uma folha
+            filho = CriaNoComRotulo(tmp->arena, caracter + i, comprimento - i);
+            AdicionaFilho(tmp, caracter[i], filho);
+            if (tmp->topk != NULL)
+                CriaCacheTopK(filho);
+            return filho;
+        }
+
+        int comum = TamanhoComum(filho->rotulo, filho->tam_rotulo, caracter + i, comprimento - i);
+        if (comum < filho->tam_rotulo)
+        {
+            filho = DivideAresta(tmp, filho, comum);
+        }
+        tmp = filho;
+        i += comum;
+    }
+    return tmp;
+}
+
+// Insere uma string (palavra) na árvore Trie, com contador 1.
 // Recebe um ponteiro para um ponteiro para a raiz da árvore e a string a ser inserida.
-// Se a árvore estiver vazia, cria o nó raiz.
-// Percorre a árvore caractere a caractere da string.
-// Para cada caractere, verifica se o nó filho correspondente existe.
-// Se não existir, cria um novo nó filho.
-// Move o ponteiro temporário para o nó filho correspondente ao caractere atual.
-// Após percorrer toda a string, marca o nó final como 'termino' = true.
 // Retorna true se a inserção for bem-sucedida (a palavra não existia), false caso contrário (a palavra já existia).
 bool adicionarNaArvore(ArvoreTrie **arv, char *texto)
 {
-    if (*arv == NULL)
+    ArvoreTrie *no = LocalizaOuCria(arv, (unsigned char *)texto, strlen(texto));
+    if (no->termino)
     {
-        *arv = CriaArvore();
+        return false;
     }
+    no->termino = 1;
+    PropagaFrequencia(no);
+    return true;
+}
 
-    ArvoreTrie *tmp = *arv;
-    unsigned char *caracter = (unsigned char *)texto;
-    int comprimento = strlen(texto);
+// Soma uma ocorrência da palavra (inserindo-a se ainda não existe).
+// Recebe os bytes e o tamanho, sem precisar de '\0': é o caminho usado pelo carregador de arquivos.
+// Retorna true se a palavra era nova.
+bool ContaOcorrencia(ArvoreTrie **arv, const unsigned char *caracter, int comprimento)
+{
+    ArvoreTrie *no = LocalizaOuCria(arv, caracter, comprimento);
+    no->termino++;
+    PropagaFrequencia(no);
+    return no->termino == 1;
+}
+
+// Retorno de chamada para cada palavra encontrada: recebe a palavra (terminada em '\0'),
+// o comprimento, a frequência e o contexto do chamador. Retornar false interrompe a coleta.
+typedef bool (*CallbackPalavra)(const char *palavra, int comprimento, unsigned int frequencia, void *contexto);
+
+// Pilha de bytes reaproveitada durante todo o percurso: ao descer uma aresta o rótulo é empilhado,
+// ao voltar o tamanho é restaurado. Evita copiar o prefixo inteiro a cada nó.
+typedef struct PilhaBytes
+{
+    unsigned char *dados;
+    int tamanho;
+    int capacidade;
+} PilhaBytes;
+
+void EmpilhaBytes(PilhaBytes *pilha, const unsigned char *bytes, int quantidade)
+{
+    // +1 para sempre caber o '\0' final
+    if (pilha->tamanho + quantidade + 1 > pilha->capacidade)
+    {
+        while (pilha->tamanho + quantidade + 1 > pilha->capacidade)
+            pilha->capacidade = pilha->capacidade ? pilha->capacidade * 2 : 64;
+        pilha->dados = (unsigned char *)realloc(pilha->dados, pilha->capacidade);
+    }
+    if (quantidade > 0)
+        memcpy(pilha->dados + pilha->tamanho, bytes, quantidade);
+    pilha->tamanho += quantidade;
+    pilha->dados[pilha->tamanho] = '\0';
+}
+
+// Percorre a subárvore em profundidade, em ordem de caractere, chamando 'callback' para cada palavra.
+// 'restante' é quantas palavras ainda podem ser entregues (negativo = sem limite) e 'entregues'
+// conta as chamadas de 'callback'. Retorna false quando a coleta deve parar.
+bool ColetaRec(ArvoreTrie *arv, PilhaBytes *pilha, int *restante, int *entregues, CallbackPalavra callback,
+               void *contexto)
+{
+    if (arv->termino)
+    {
+        if (*restante == 0)
+            return false;
+        if (*restante > 0)
+            (*restante)--;
+        (*entregues)++;
+        pilha->dados[pilha->tamanho] = '\0';
+        if (!callback((char *)pilha->dados, pilha->tamanho, arv->termino, contexto))
+            return false;
+    }
+
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(arv, &pos, &c, &filho))
+    {
+        int tamanho_antes = pilha->tamanho;
+        EmpilhaBytes(pilha, filho->rotulo, filho->tam_rotulo);
+        bool continua = ColetaRec(filho, pilha, restante, entregues, callback, contexto);
+        pilha->tamanho = tamanho_antes;
+        if (!continua)
+            return false;
+    }
+    return true;
+}
+
+// Desce pelo prefixo e retorna o nó cuja subárvore contém exatamente as palavras com esse prefixo
+// (ou NULL se não houver nenhuma). Se o prefixo terminar no meio de um rótulo, o nó retornado é o
+// filho daquela aresta e '*sobra' recebe quantos bytes do rótulo ficaram além do prefixo.
+ArvoreTrie *LocalizaPrefixo(ArvoreTrie *arv, const unsigned char *prefixo, int comprimento, int *sobra)
+{
+    ArvoreTrie *tmp = arv;
+    int i = 0;
+    *sobra = 0;
+
+    if (arv == NULL)
+        return NULL;
+
+    while (i < comprimento)
+    {
+        tmp = ObtemFilho(tmp, prefixo[i]);
+        if (tmp == NULL)
+        {
+            return NULL;
+        }
+        // O prefixo pode terminar no meio do rótulo da aresta
+        int comum = TamanhoComum(tmp->rotulo, tmp->tam_rotulo, prefixo + i, comprimento - i);
+        if (comum < tmp->tam_rotulo && comum < comprimento - i)
+        {
+            return NULL;
+        }
+        *sobra = tmp->tam_rotulo - comum;
+        i += comum;
+    }
+    return tmp;
+}
+
+// Entrega para 'callback' as palavras que começam com 'prefixo', em ordem, até 'limite' palavras
+// (limite <= 0 = todas). Anda só pela subárvore do prefixo usando uma única pilha de bytes.
+// Retorna quantas palavras foram entregues.
+int ColetaComPrefixo(ArvoreTrie *arv, char *prefixo, int limite, CallbackPalavra callback, void *contexto)
+{
+    int comprimento = strlen(prefixo);
+    int sobra;
+    ArvoreTrie *no = LocalizaPrefixo(arv, (unsigned char *)prefixo, comprimento, &sobra);
+    if (no == NULL)
+        return 0;
+
+    PilhaBytes pilha = {NULL, 0, 0};
+    EmpilhaBytes(&pilha, (unsigned char *)prefixo, comprimento);
+    EmpilhaBytes(&pilha, no->rotulo + no->tam_rotulo - sobra, sobra);
+
+    int restante = limite > 0 ? limite : -1;
+    int entregues = 0;
+    ColetaRec(no, &pilha, &restante, &entregues, callback, contexto);
+    free(pilha.dados);
+
+    return entregues;
+}
+
+// Monta na pilha a palavra completa de um nó, subindo pelos pais e juntando os rótulos.
+void ReconstroiPalavra(ArvoreTrie *no, PilhaBytes *pilha)
+{
+    // A raiz (pai == NULL) tem rótulo vazio e fica de fora
+    int comprimento = 0;
+    for (ArvoreTrie *atual = no; atual->pai != NULL; atual = atual->pai)
+        comprimento += atual->tam_rotulo;
+
+    if (comprimento + 1 > pilha->capacidade)
+    {
+        pilha->capacidade = comprimento + 1;
+        pilha->dados = (unsigned char *)realloc(pilha->dados, pilha->capacidade);
+    }
+    pilha->tamanho = comprimento;
+    pilha->dados[comprimento] = '\0';
+    for (ArvoreTrie *atual = no; atual->pai != NULL; atual = atual->pai)
+    {
+        comprimento -= atual->tam_rotulo;
+        memcpy(pilha->dados + comprimento, atual->rotulo, atual->tam_rotulo);
+    }
+}
+
+// Sem cache: varre a subárvore guardando os 'k' nós de maior frequência.
+void ColetaTopKRec(ArvoreTrie *arv, ArvoreTrie **melhores, int *quantidade, int k)
+{
+    if (arv->termino)
+        InsereEntreMelhores(melhores, quantidade, k, arv);
+
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(arv, &pos, &c, &filho))
+    {
+        ColetaTopKRec(filho, melhores, quantidade, k);
+    }
+}
+
+// Autocompletar: entrega as até 'k' palavras mais frequentes com o prefixo, da mais para a menos frequente.
+// Com o cache ativo (e k <= TOPK) custa O(tamanho do prefixo + k palavras), sem varrer a subárvore.
+// Sem o cache, varre a subárvore do prefixo. Retorna quantas palavras foram entregues.
+int AutocompletaTopK(ArvoreTrie *arv, char *prefixo, int k, CallbackPalavra callback, void *contexto)
+{
+    int sobra;
+    ArvoreTrie *no = LocalizaPrefixo(arv, (unsigned char *)prefixo, strlen(prefixo), &sobra);
+    if (no == NULL || k <= 0)
+        return 0;
+
+    ArvoreTrie *escolhidos[TOPK];
+    ArvoreTrie **melhores = escolhidos;
+    bool alocado = false;
+    int quantidade = 0;
+
+    if (no->topk != NULL && k <= TOPK)
+    {
+        quantidade = no->topk->quantidade < k ? no->topk->quantidade : k;
+        melhores = no->topk->nos;
+    }
+    else
+    {
+        if (k > TOPK)
+        {
+            melhores = (ArvoreTrie **)malloc(k * sizeof(ArvoreTrie *));
+            alocado = true;
+        }
+        ColetaTopKRec(no, melhores, &quantidade, k);
+    }
+
+    PilhaBytes pilha = {NULL, 0, 0};
+    int entregues = 0;
+    while (entregues < quantidade)
+    {
+        ArvoreTrie *escolhido = melhores[entregues++];
+        ReconstroiPalavra(escolhido, &pilha);
+        if (!callback((char *)pilha.dados, pilha.tamanho, escolhido->termino, contexto))
+            break;
+    }
+    free(pilha.dados);
+    if (alocado)
+        free(melhores);
+    return entregues;
+}
+
+// Registra 'incremento' usos de uma palavra existente (aumenta a frequência usada no autocompletar).
+// Retorna false se a palavra não está na árvore.
+bool RegistraUso(ArvoreTrie *arv, char *texto, unsigned int incremento)
+{
+    int sobra;
+    ArvoreTrie *no = LocalizaPrefixo(arv, (unsigned char *)texto, strlen(texto), &sobra);
+    if (no == NULL || sobra != 0 || !no->termino)
+        return false;
+
+    no->termino += incremento;
+    PropagaFrequencia(no);
+    return true;
+}
+
+// Cria o cache de top-k de um nó e de toda a subárvore (de baixo para cima).
+void HabilitaTopKRec(ArvoreTrie *arv)
+{
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(arv, &pos, &c, &filho))
+    {
+        HabilitaTopKRec(filho);
+    }
+    if (arv->topk == NULL)
+        CriaCacheTopK(arv);
+    RecalculaCacheTopK(arv);
+}
+
+// Ativa o cache de autocompletar: cada nó passa a guardar as TOPK palavras mais frequentes
+// da sua subárvore, mantidas nas inserções, remoções e registros de uso.
+// Custa um ponteiro extra por nó mais o cache (TOPK ponteiros).
+void HabilitaTopK(ArvoreTrie **arv)
+{
+    if (*arv == NULL)
+        *arv = CriaArvore(CriaArena());
+    HabilitaTopKRec(*arv);
+}
+
+bool ImprimePalavra(const char *palavra, int comprimento, unsigned int frequencia, void *contexto)
+{
+    (void)comprimento;
+    (void)frequencia;
+    (void)contexto;
+    printf("Palavra: %s\n", palavra);
+    return true;
+}
+
+bool ImprimePalavraComFrequencia(const char *palavra, int comprimento, unsigned int frequencia, void *contexto)
+{
+    (void)comprimento;
+    (void)contexto;
+    printf("Palavra: %s (frequencia %u)\n", palavra, frequencia);
+    return true;
+}
+
+void ImprimeArvore(ArvoreTrie *arv)
+{
+    if (arv == NULL)
+    {
+        printf("Arvore Vazia\n");
+        return;
+    }
+
+    ColetaComPrefixo(arv, "", 0, ImprimePalavra, NULL);
+}
+
+// ---------------------------------------------------------------------------
+// Busca aproximada (distância de Levenshtein).
+// Percorre a árvore mantendo uma linha da tabela de programação dinâmica por profundidade:
+// a linha da profundidade d guarda a distância entre os d primeiros bytes do caminho e cada
+// prefixo da consulta. Descer um byte calcula só uma linha nova a partir da anterior, e prefixos
+// comuns a muitas palavras são calculados uma vez só. Se o menor valor da linha já passa do
+// limite, nenhuma palavra da subárvore pode ficar dentro dele e a subárvore é podada.
+// ---------------------------------------------------------------------------
+
+// Retorno de chamada da busca aproximada: como CallbackPalavra, mais a distância até a consulta.
+typedef bool (*CallbackAproximada)(const char *palavra, int comprimento, unsigned int frequencia, int distancia,
+                                   void *contexto);
+
+typedef struct BuscaAproximada
+{
+    const unsigned char *consulta;
+    int tam_consulta;
+    int max_distancia;
+    int *linhas;            // linha d em linhas[d * (tam_consulta + 1)]
+    int capacidade_linhas;  // quantidade de linhas alocadas
+    PilhaBytes pilha;       // bytes do caminho atual
+    CallbackAproximada callback;
+    void *contexto;
+    int encontradas;
+    long nos_visitados;
+} BuscaAproximada;
+
+// Calcula a linha 'profundidade' a partir da anterior, para o byte 'c'; retorna o menor valor da linha.
+// Só a faixa de colunas j com |j - profundidade| <= max_distancia pode ficar dentro do limite, então
+// só ela é calculada; valores acima do limite ficam saturados em max_distancia + 1.
+int CalculaLinhaDistancia(BuscaAproximada *busca, int profundidade, unsigned char c)
+{
+    int largura = busca->tam_consulta + 1;
+    int estouro = busca->max_distancia + 1;
+    int inicio = profundidade - busca->max_distancia;
+    int fim = profundidade + busca->max_distancia;
+    if (inicio > busca->tam_consulta)
+        return estouro; // o caminho já é mais longo que a consulta mais o limite
+    if (inicio < 1)
+        inicio = 1;
+    if (fim > busca->tam_consulta)
+        fim = busca->tam_consulta;
+
+    if (profundidade >= busca->capacidade_linhas)
+    {
+        while (profundidade >= busca->capacidade_linhas)
+            busca->capacidade_linhas *= 2;
+        busca->linhas = (int *)realloc(busca->linhas, (size_t)busca->capacidade_linhas * largura * sizeof(int));
+    }
+
+    int *anterior = busca->linhas + (size_t)(profundidade - 1) * largura;
+    int *linha = anterior + largura;
+    linha[0] = profundidade < estouro ? profundidade : estouro;
+    linha[inicio - 1] = inicio > 1 ? estouro : linha[0];
+    int minimo = linha[inicio - 1];
+    for (int j = inicio; j <= fim; j++)
+    {
+        int valor = anterior[j - 1] + (busca->consulta[j - 1] != c); // troca (ou igual)
+        if (anterior[j] + 1 < valor)
+            valor = anterior[j] + 1; // byte a mais no caminho
+        if (linha[j - 1] + 1 < valor)
+            valor = linha[j - 1] + 1; // byte a mais na consulta
+        if (valor > estouro)
+            valor = estouro;
+        linha[j] = valor;
+        if (valor < minimo)
+            minimo = valor;
+    }
+    // Sentinela lida pela próxima linha, cuja faixa avança uma coluna
+    if (fim < busca->tam_consulta)
+        linha[fim + 1] = estouro;
+    return minimo;
+}
+
+// Retorna false quando o chamador pediu para parar.
+bool BuscaAproximadaRec(BuscaAproximada *busca, ArvoreTrie *no)
+{
+    int profundidade = busca->pilha.tamanho;
+    int distancia = busca->max_distancia + 1;
+    // A última coluna só foi calculada se estiver na faixa da linha
+    if (busca->tam_consulta - profundidade <= busca->max_distancia)
+        distancia = busca->linhas[(size_t)profundidade * (busca->tam_consulta + 1) + busca->tam_consulta];
+    busca->nos_visitados++;
+
+    if (no->termino && distancia <= busca->max_distancia)
+    {
+        busca->encontradas++;
+        if (!busca->callback((char *)busca->pilha.dados, profundidade, no->termino, distancia, busca->contexto))
+            return false;
+    }
+
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(no, &pos, &c, &filho))
+    {
+        // Uma linha por byte do rótulo; se alguma já estoura o limite, a subárvore inteira é podada
+        bool dentro = true;
+        for (int i = 0; i < filho->tam_rotulo && dentro; i++)
+            dentro = CalculaLinhaDistancia(busca, profundidade + i + 1, filho->rotulo[i]) <= busca->max_distancia;
+        if (!dentro)
+            continue;
+
+        EmpilhaBytes(&busca->pilha, filho->rotulo, filho->tam_rotulo);
+        bool continua = BuscaAproximadaRec(busca, filho);
+        busca->pilha.tamanho = profundidade;
+        if (!continua)
+            return false;
+    }
+    return true;
+}
+
+// Chama 'callback' para cada palavra a no máximo 'max_distancia' edições (inserção, remoção
+// ou troca de um byte) de 'consulta', em ordem crescente de bytes. Retorna quantas foram encontradas.
+int ProcuraAproximada(ArvoreTrie *arv, char *consulta, int max_distancia, CallbackAproximada callback,
+                      void *contexto, long *nos_visitados)
+{
+    BuscaAproximada busca;
+    busca.consulta = (unsigned char *)consulta;
+    busca.tam_consulta = strlen(consulta);
+    busca.max_distancia = max_distancia;
+    busca.capacidade_linhas = 32;
+    busca.linhas = (int *)malloc((size_t)busca.capacidade_linhas * (busca.tam_consulta + 1) * sizeof(int));
+    busca.pilha = (PilhaBytes){NULL, 0, 0};
+    busca.callback = callback;
+    busca.contexto = contexto;
+    busca.encontradas = 0;
+    busca.nos_visitados = 0;
+
+    // Linha 0: caminho vazio contra cada prefixo da consulta
+    for (int j = 0; j <= busca.tam_consulta; j++)
+        busca.linhas[j] = j;
+
+    if (arv != NULL && max_distancia >= 0)
+    {
+        EmpilhaBytes(&busca.pilha, NULL, 0);
+        BuscaAproximadaRec(&busca, arv);
+    }
+
+    if (nos_visitados != NULL)
+        *nos_visitados = busca.nos_visitados;
+    free(busca.pilha.dados);
+    free(busca.linhas);
+    return busca.encontradas;
+}
+
+bool ImprimePalavraComDistancia(const char *palavra, int comprimento, unsigned int frequencia, int distancia,
+                                void *contexto)
+{
+    (void)comprimento;
+    (void)contexto;
+    printf("Palavra: %s (distancia %d, frequencia %u)\n", palavra, distancia, frequencia);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Carga em massa: lê um arquivo texto em blocos, separa as palavras e conta as ocorrências na árvore.
+// Cada palavra vai direto do bloco lido para ContaOcorrencia, sem cópia intermediária; só a palavra
+// que atravessa a fronteira entre dois blocos é juntada numa pilha de bytes.
+// ---------------------------------------------------------------------------
+
+#define TAM_BLOCO_LEITURA (1 << 16)
+
+// Classe de cada byte na separação de palavras: 0 = separador; senão, o byte já normalizado.
+// Segue a mesma regra do menu: letras ASCII, convertidas para maiúsculas, e qualquer byte >= 0x80,
+// para que as sequências UTF-8 (letras acentuadas, outros alfabetos) fiquem inteiras dentro da palavra.
+// Como os separadores são todos ASCII, uma palavra nunca é cortada no meio de um caractere UTF-8.
+static unsigned char classe_byte[NUM_CHARS];
+static bool classes_prontas = false;
+
+void InicializaClassesBytes()
+{
+    for (int c = 0; c < NUM_CHARS; c++)
+        classe_byte[c] = c >= 0x80 ? (unsigned char)c : isalpha(c) ? (unsigned char)toupper(c) : 0;
+    classes_prontas = true;
+}
+
+// Converte para maiúsculas as letras acentuadas do Latin-1 (U+00E0 a U+00FE, exceto U+00F7),
+// que em UTF-8 são C3 A0 a C3 BE: basta subtrair 0x20 do segundo byte. É o que cobre o português;
+// letras de outros alfabetos ficam como estão (seria preciso a tabela de maiúsculas do Unicode).
+void MaiusculasUtf8(unsigned char *texto, int tamanho)
+{
+    for (int i = 0; i + 1 < tamanho; i++)
+    {
+        if (texto[i] == 0xC3 && texto[i + 1] >= 0xA0 && texto[i + 1] <= 0xBE && texto[i + 1] != 0xB7)
+            texto[i + 1] -= 0x20;
+    }
+}
+
+typedef struct ResultadoCarga
+{
+    long long bytes;
+    long long palavras;  // ocorrências lidas
+    long long distintas; // palavras que ainda não estavam na árvore
+    double segundos;
+} ResultadoCarga;
+
+bool CarregaArquivoTexto(ArvoreTrie **arv, const char *nome_arquivo, ResultadoCarga *resultado)
+{
+    FILE *arquivo = fopen(nome_arquivo, "rb");
+    if (arquivo == NULL)
+        return false;
+
+    if (!classes_prontas)
+        InicializaClassesBytes();
+
+    unsigned char *bloco = (unsigned char *)malloc(TAM_BLOCO_LEITURA);
+    PilhaBytes pendente = {NULL, 0, 0}; // palavra cortada no fim do bloco anterior
+    size_t lidos;
+    memset(resultado, 0, sizeof(ResultadoCarga));
+    clock_t inicio = clock();
+
+    while ((lidos = fread(bloco, 1, TAM_BLOCO_LEITURA, arquivo)) > 0)
+    {
+        resultado->bytes += lidos;
+        size_t i = 0;
+        while (i < lidos)
+        {
+            if (pendente.tamanho == 0)
+            {
+                while (i < lidos && classe_byte[bloco[i]] == 0)
+                    i++;
+            }
+            size_t inicio_palavra = i;
+            unsigned char bits = 0; // bit 7 ligado = a palavra tem bytes UTF-8
+            while (i < lidos && classe_byte[bloco[i]] != 0)
+            {
+                bloco[i] = classe_byte[bloco[i]];
+                bits |= bloco[i];
+                i++;
+            }
+            if (bits & 0x80)
+                MaiusculasUtf8(bloco + inicio_palavra, i - inicio_palavra);
+
+            if (i == lidos)
+            {
+                // A palavra pode continuar no próximo bloco
+                if (i > inicio_palavra)
+                    EmpilhaBytes(&pendente, bloco + inicio_palavra, i - inicio_palavra);
+                break;
+            }
+
+            bool nova;
+            if (pendente.tamanho > 0)
+            {
+                EmpilhaBytes(&pendente, bloco + inicio_palavra, i - inicio_palavra);
+                MaiusculasUtf8(pendente.dados, pendente.tamanho); // a sequência pode ter sido cortada entre os blocos
+                nova = ContaOcorrencia(arv, pendente.dados, pendente.tamanho);
+                pendente.tamanho = 0;
+            }
+            else
+            {
+                nova = ContaOcorrencia(arv, bloco + inicio_palavra, i - inicio_palavra);
+            }
+            resultado->palavras++;
+            resultado->distintas += nova;
+            i++; // pula o separador
+        }
+    }
+    if (pendente.tamanho > 0)
+    {
+        MaiusculasUtf8(pendente.dados, pendente.tamanho);
+        resultado->distintas += ContaOcorrencia(arv, pendente.dados, pendente.tamanho);
+        resultado->palavras++;
+    }
+
+    resultado->segundos = (double)(clock() - inicio) / CLOCKS_PER_SEC;
+    free(pendente.dados);
+    free(bloco);
+    fclose(arquivo);
+    return true;
+}
+
+void MostraResultadoCarga(ResultadoCarga *resultado)
+{
+    double megabytes = resultado->bytes / (1024.0 * 1024.0);
+    printf("Lidos %.2f MB: %lld palavras, %lld novas, em %.3f s", megabytes, resultado->palavras,
+           resultado->distintas, resultado->segundos);
+    if (resultado->segundos > 0)
+        printf(" (%.1f MB/s)", megabytes / resultado->segundos);
+    printf("\n");
+}
+
+// ---------------------------------------------------------------------------
+// Trie concorrente para ingestão com várias threads.
+// A árvore principal (nós adaptativos, arestas comprimidas, arena) reorganiza nós a cada inserção
+// e não tem como ser publicada com uma única troca atômica. Aqui cada nó tem 16 filhos fixos
+// (cada byte consome dois níveis: nibble alto e nibble baixo), e um filho só é instalado, nunca
+// trocado: a thread cria o nó especulativamente e tenta instalá-lo com compare-and-swap; quem
+// perde a disputa libera o seu e segue pelo nó do vencedor. Não há remoção nesse modo.
+// Busca e verificação de prefixo só fazem leituras atômicas, no máximo duas por byte: são wait-free.
+// Terminada a ingestão, as palavras (com as contagens) são transferidas para a árvore principal.
+// ---------------------------------------------------------------------------
+
+#define FILHOS_CONCORRENTE 16
+#define MAX_THREADS 64
+
+typedef struct NoConcorrente
+{
+    _Atomic(struct NoConcorrente *) filhos[FILHOS_CONCORRENTE];
+    atomic_uint termino; // ocorrências da palavra (só nos nós de nibble baixo, isto é, ao fim de um byte)
+} NoConcorrente;
+
+typedef struct TrieConcorrente
+{
+    NoConcorrente *raiz;
+    atomic_long nos_criados;
+    atomic_long disputas_perdidas; // CAS perdidos (nó especulativo descartado)
+} TrieConcorrente;
+
+NoConcorrente *CriaNoConcorrente()
+{
+    NoConcorrente *no = (NoConcorrente *)malloc(sizeof(NoConcorrente));
+    for (int i = 0; i < FILHOS_CONCORRENTE; i++)
+        atomic_init(&no->filhos[i], NULL);
+    atomic_init(&no->termino, 0);
+    return no;
+}
+
+TrieConcorrente *CriaTrieConcorrente()
+{
+    TrieConcorrente *trie = (TrieConcorrente *)malloc(sizeof(TrieConcorrente));
+    trie->raiz = CriaNoConcorrente();
+    atomic_init(&trie->nos_criados, 1);
+    atomic_init(&trie->disputas_perdidas, 0);
+    return trie;
+}
+
+// Retorna o filho 'nibble' de 'no', instalando um novo se ainda não existir.
+NoConcorrente *FilhoOuInstala(TrieConcorrente *trie, NoConcorrente *no, int nibble)
+{
+    NoConcorrente *filho = atomic_load_explicit(&no->filhos[nibble], memory_order_acquire);
+    if (filho != NULL)
+        return filho;
+
+    NoConcorrente *novo = CriaNoConcorrente();
+    NoConcorrente *esperado = NULL;
+    if (atomic_compare_exchange_strong_explicit(&no->filhos[nibble], &esperado, novo,
+                                                memory_order_acq_rel, memory_order_acquire))
+    {
+        atomic_fetch_add_explicit(&trie->nos_criados, 1, memory_order_relaxed);
+        return novo;
+    }
+
+    // Outra thread instalou primeiro: 'esperado' agora é o nó dela
+    free(novo);
+    atomic_fetch_add_explicit(&trie->disputas_perdidas, 1, memory_order_relaxed);
+    return esperado;
+}
+
+// Soma uma ocorrência da palavra; pode ser chamada por várias threads ao mesmo tempo.
+// Retorna true se esta chamada foi a primeira ocorrência da palavra.
+bool ContaOcorrenciaConcorrente(TrieConcorrente *trie, const unsigned char *caracter, int comprimento)
+{
+    NoConcorrente *no = trie->raiz;
+    for (int i = 0; i < comprimento; i++)
+    {
+        no = FilhoOuInstala(trie, no, caracter[i] >> 4);
+        no = FilhoOuInstala(trie, no, caracter[i] & 0x0F);
+    }
+    return atomic_fetch_add_explicit(&no->termino, 1, memory_order_release) == 0;
+}
+
+// Desce pelos bytes sem criar nada; retorna NULL se o caminho não existe.
+NoConcorrente *LocalizaConcorrente(TrieConcorrente *trie, const unsigned char *caracter)
+{
+    NoConcorrente *no = trie->raiz;
+    for (int i = 0; caracter[i] != '\0' && no != NULL; i++)
+    {
+        no = atomic_load_explicit(&no->filhos[caracter[i] >> 4], memory_order_acquire);
+        if (no != NULL)
+            no = atomic_load_explicit(&no->filhos[caracter[i] & 0x0F], memory_order_acquire);
+    }
+    return no;
+}
+
+bool ProcuraConcorrente(TrieConcorrente *trie, char *texto)
+{
+    NoConcorrente *no = LocalizaConcorrente(trie, (unsigned char *)texto);
+    return no != NULL && atomic_load_explicit(&no->termino, memory_order_acquire) > 0;
+}
+
+// Como não há remoção, um nó só existe se alguma palavra passou (ou está passando) por ele.
+// Durante a ingestão, uma palavra cujo caminho já foi instalado mas cujo contador ainda não foi
+// incrementado conta como existente para o prefixo.
+bool VerificaPrefixoConcorrente(TrieConcorrente *trie, char *prefixo)
+{
+    NoConcorrente *no = LocalizaConcorrente(trie, (unsigned char *)prefixo);
+    if (no == NULL)
+        return false;
+    if (no != trie->raiz || atomic_load_explicit(&no->termino, memory_order_acquire) > 0)
+        return true;
+    for (int i = 0; i < FILHOS_CONCORRENTE; i++)
+        if (atomic_load_explicit(&no->filhos[i], memory_order_acquire) != NULL)
+            return true;
+    return false;
+}
+
+// Percorre em ordem de bytes, montando cada byte a partir dos dois nibbles.
+// Só deve ser chamada depois que todas as threads de ingestão terminaram.
+void TransfereRec(NoConcorrente *no, bool nibble_baixo, int alto, PilhaBytes *pilha, ArvoreTrie **arv)
+{
+    unsigned int contagem = atomic_load_explicit(&no->termino, memory_order_relaxed);
+    if (!nibble_baixo && contagem > 0)
+    {
+        ArvoreTrie *destino = LocalizaOuCria(arv, pilha->dados, pilha->tamanho);
+        destino->termino += contagem;
+        PropagaFrequencia(destino);
+    }
+
+    for (int i = 0; i < FILHOS_CONCORRENTE; i++)
+    {
+        NoConcorrente *filho = atomic_load_explicit(&no->filhos[i], memory_order_relaxed);
+        if (filho == NULL)
+            continue;
+        if (nibble_baixo)
+        {
+            unsigned char byte = (unsigned char)(alto << 4 | i);
+            EmpilhaBytes(pilha, &byte, 1);
+            TransfereRec(filho, false, 0, pilha, arv);
+            pilha->tamanho--;
+        }
+        else
+        {
+            TransfereRec(filho, true, i, pilha, arv);
+        }
+    }
+}
+
+// Soma todas as palavras da trie concorrente (com as contagens) na árvore principal.
+void TransfereParaArvore(TrieConcorrente *trie, ArvoreTrie **arv)
+{
+    PilhaBytes pilha = {NULL, 0, 0};
+    EmpilhaBytes(&pilha, NULL, 0);
+    TransfereRec(trie->raiz, false, 0, &pilha, arv);
+    free(pilha.dados);
+}
+
+void LiberaNoConcorrente(NoConcorrente *no)
+{
+    for (int i = 0; i < FILHOS_CONCORRENTE; i++)
+    {
+        NoConcorrente *filho = atomic_load_explicit(&no->filhos[i], memory_order_relaxed);
+        if (filho != NULL)
+            LiberaNoConcorrente(filho);
+    }
+    free(no);
+}
+
+void LiberaTrieConcorrente(TrieConcorrente *trie)
+{
+    if (trie == NULL)
+        return;
+    LiberaNoConcorrente(trie->raiz);
+    free(trie);
+}
+
+// Trecho do texto entregue a uma thread de ingestão
+typedef struct TarefaCarga
+{
+    TrieConcorrente *trie;
+    unsigned char *inicio;
+    unsigned char *fim;
+    long long palavras;
+    long long distintas;
+} TarefaCarga;
+
+void *ExecutaTarefaCarga(void *argumento)
+{
+    TarefaCarga *tarefa = (TarefaCarga *)argumento;
+    unsigned char *p = tarefa->inicio;
+
+    while (p < tarefa->fim)
+    {
+        while (p < tarefa->fim && classe_byte[*p] == 0)
+            p++;
+        unsigned char *inicio_palavra = p;
+        unsigned char bits = 0;
+        while (p < tarefa->fim && classe_byte[*p] != 0)
+        {
+            *p = classe_byte[*p];
+            bits |= *p;
+            p++;
+        }
+        if (bits & 0x80)
+            MaiusculasUtf8(inicio_palavra, p - inicio_palavra);
+        if (p > inicio_palavra)
+        {
+            tarefa->distintas += ContaOcorrenciaConcorrente(tarefa->trie, inicio_palavra, p - inicio_palavra);
+            tarefa->palavras++;
+        }
+    }
+    return NULL;
+}
+
+double RelogioSegundos()
+{
+    struct timespec agora;
+    timespec_get(&agora, TIME_UTC);
+    return agora.tv_sec + agora.tv_nsec / 1e9;
+}
+
+// Lê o arquivo inteiro para a memória (a leitura não entra no tempo medido).
+unsigned char *LeArquivoInteiro(const char *nome_arquivo, size_t *tamanho)
+{
+    FILE *arquivo = fopen(nome_arquivo, "rb");
+    if (arquivo == NULL)
+        return NULL;
+
+    size_t capacidade = TAM_BLOCO_LEITURA;
+    unsigned char *dados = (unsigned char *)malloc(capacidade);
+    size_t lidos;
+    *tamanho = 0;
+    while ((lidos = fread(dados + *tamanho, 1, capacidade - *tamanho, arquivo)) > 0)
+    {
+        *tamanho += lidos;
+        if (*tamanho == capacidade)
+        {
+            capacidade *= 2;
+            dados = (unsigned char *)realloc(dados, capacidade);
+        }
+    }
+    fclose(arquivo);
+    return dados;
+}
+
+// Divide o texto em 'num_threads' trechos (cortando só em separadores, para nenhuma palavra
+// ficar partida entre duas threads) e insere todos em paralelo na trie concorrente.
+void CarregaTextoParalelo(TrieConcorrente *trie, unsigned char *dados, size_t tamanho, int num_threads,
+                          ResultadoCarga *resultado)
+{
+    pthread_t threads[MAX_THREADS];
+    TarefaCarga tarefas[MAX_THREADS];
+
+    if (!classes_prontas)
+        InicializaClassesBytes();
+
+    unsigned char *fim_texto = dados + tamanho;
+    unsigned char *corte = dados;
+    for (int t = 0; t < num_threads; t++)
+    {
+        unsigned char *fim = t == num_threads - 1 ? fim_texto : dados + tamanho / num_threads * (t + 1);
+        if (fim < corte)
+            fim = corte;
+        while (fim < fim_texto && classe_byte[*fim] != 0)
+            fim++;
+        tarefas[t] = (TarefaCarga){trie, corte, fim, 0, 0};
+        corte = fim;
+    }
+
+    double inicio = RelogioSegundos();
+    for (int t = 0; t < num_threads; t++)
+        pthread_create(&threads[t], NULL, ExecutaTarefaCarga, &tarefas[t]);
+
+    memset(resultado, 0, sizeof(ResultadoCarga));
+    for (int t = 0; t < num_threads; t++)
+    {
+        pthread_join(threads[t], NULL);
+        resultado->palavras += tarefas[t].palavras;
+        resultado->distintas += tarefas[t].distintas;
+    }
+    resultado->segundos = RelogioSegundos() - inicio;
+    resultado->bytes = tamanho;
+}
+
+// Mede a vazão de inserção com 1, 2, 4, ... threads (até 'max_threads'), sempre numa trie nova.
+void BenchmarkConcorrente(const char *nome_arquivo, int max_threads)
+{
+    size_t tamanho;
+    unsigned char *original = LeArquivoInteiro(nome_arquivo, &tamanho);
+    if (original == NULL)
+    {
+        printf("Erro ao abrir '%s'!\n", nome_arquivo);
+        return;
+    }
+
+    // Cada rodada normaliza o texto no lugar, então trabalha sobre uma cópia
+    unsigned char *dados = (unsigned char *)malloc(tamanho > 0 ? tamanho : 1);
+    double vazao_uma = 0;
+    for (int num_threads = 1; num_threads <= max_threads; num_threads *= 2)
+    {
+        memcpy(dados, original, tamanho);
+        TrieConcorrente *trie = CriaTrieConcorrente();
+        ResultadoCarga resultado;
+        CarregaTextoParalelo(trie, dados, tamanho, num_threads, &resultado);
+
+        double vazao = resultado.segundos > 0 ? resultado.bytes / (1024.0 * 1024.0) / resultado.segundos : 0;
+        if (num_threads == 1)
+            vazao_uma = vazao;
+        printf("%2d thread(s): %lld palavras, %lld distintas, %.3f s, %.1f MB/s (%.2fx), %ld CAS perdidos\n",
+               num_threads, resultado.palavras, resultado.distintas, resultado.segundos, vazao,
+               vazao_uma > 0 ? vazao / vazao_uma : 0, atomic_load(&trie->disputas_perdidas));
+        LiberaTrieConcorrente(trie);
+    }
+    free(dados);
+    free(original);
+}
+
+bool procurarNaArvore(ArvoreTrie *arv, char *texto)
+{
+    unsigned char *caracter = (unsigned char *)texto;
+    int comprimento = strlen(texto);
+    ArvoreTrie *tmp = arv;
+    int i = 0;
+
+    if (arv == NULL)
+        return false;
+
+    // Cada passo consome uma aresta inteira: o custo depende das bifurcações, não do tamanho da palavra
+    while (i < comprimento)
+    {
+        tmp = ObtemFilho(tmp, caracter[i]);
+        if (tmp == NULL || tmp->tam_rotulo > comprimento - i ||
+            memcmp(tmp->rotulo, caracter + i, tmp->tam_rotulo) != 0)
+        {
+            return false;
+        }
+        i += tmp->tam_rotulo;
+    }
+    return tmp->termino;
+}
+
+// O(1): usa o contador de filhos mantido junto com o bitmap, sem varrer posições
+bool no_tem_filho(ArvoreTrie *arv)
+{
+    if (arv == NULL)
+        return false;
+    return arv->num_filhos > 0;
+}
+
+// Libera um nó (cabeçalho e vetores de filhos), sem descer para os filhos.
+// Os blocos voltam para as listas livres da arena e são reaproveitados nas próximas inserções.
+void LiberaNo(ArvoreTrie *arv)
+{
+    ArenaTrie *arena = arv->arena;
+    ArenaLibera(arena, arv->topk, sizeof(CacheTopK));
+    ArenaLibera(arena, arv->rotulo, arv->tam_rotulo);
+    LiberaVetoresFilhos(arv);
+    ArenaLibera(arena, arv, sizeof(ArvoreTrie));
+}
+
+// Libera a árvore inteira de uma vez, devolvendo os slabs da arena dela sem percorrer os nós.
+// Usada para descartar e reconstruir a árvore; outras árvores (com as suas arenas) não são afetadas.
+void LiberaArvore(ArvoreTrie **arv)
+{
+    if (*arv != NULL)
+        ArenaDestroi((*arv)->arena);
+    *arv = NULL;
+}
+
+// Junta um nó sem palavra e com um único filho à aresta desse filho:
+// o rótulo do filho passa a ser rótulo do nó + rótulo do filho, e o nó é liberado.
+// Retorna o filho, que ocupa o lugar do nó no pai.
+ArvoreTrie *FundeComFilho(ArvoreTrie *arv)
+{
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    ProximoFilho(arv, &pos, &c, &filho);
+
+    unsigned char *rotulo = (unsigned char *)ArenaAloca(arv->arena, arv->tam_rotulo + filho->tam_rotulo, false);
+    memcpy(rotulo, arv->rotulo, arv->tam_rotulo);
+    memcpy(rotulo + arv->tam_rotulo, filho->rotulo, filho->tam_rotulo);
+    ArenaLibera(arv->arena, filho->rotulo, filho->tam_rotulo);
+    filho->rotulo = rotulo;
+    filho->tam_rotulo += arv->tam_rotulo;
+
+    RemoveFilho(arv, c);
+    LiberaNo(arv);
+    return filho;
+}
+
+// Versão recursiva da remoção, usada quando o caminho não cabe na pilha fixa de RemoveComCaminho.
+// Remove 'texto' (o que falta da palavra depois do rótulo de 'arv') da subárvore.
+// Retorna o nó que deve ficar no lugar de 'arv' no pai: o próprio nó, NULL se ele foi liberado,
+// ou o filho com quem ele foi fundido. A raiz nunca é fundida, pois não tem aresta de entrada.
+ArvoreTrie *RemoveArvRec(ArvoreTrie *arv, unsigned char *texto, bool *removido)
+{
+    if (arv == NULL)
+        return arv;
+
+    if (*texto == '\0')
+    {
+        if (arv->termino)
+        {
+            arv->termino = 0;
+            *removido = true;
+            if (!no_tem_filho(arv))
+            {
+                LiberaNo(arv);
+                arv = NULL;
+            }
+            else if (arv->topk != NULL)
+            {
+                RecalculaCacheTopK(arv);
+            }
+        }
+        return arv;
+    }
+
+    ArvoreTrie *filho = ObtemFilho(arv, *texto);
+    if (filho == NULL || (int)strlen((char *)texto) < filho->tam_rotulo ||
+        memcmp(filho->rotulo, texto, filho->tam_rotulo) != 0)
+        return arv;
+
+    unsigned char c = *texto;
+    ArvoreTrie *novo = RemoveArvRec(filho, texto + filho->tam_rotulo, removido);
+
+    if (novo == NULL)
+        RemoveFilho(arv, c);
+    else if (!novo->termino && novo->num_filhos == 1)
+        SubstituiFilho(arv, c, FundeComFilho(novo)); // re-junta as arestas que ficaram sem bifurcação
+
+    if (*removido && !no_tem_filho(arv) && !arv->termino)
+    {
+        LiberaNo(arv);
+        arv = NULL;
+    }
+    else if (*removido && arv->topk != NULL)
+    {
+        // A palavra removida pode estar no cache deste nó
+        RecalculaCacheTopK(arv);
+    }
+
+    return arv;
+}
+
+// Caminho da raiz até o nó atual durante a remoção, numa pilha de tamanho fixo (sem alocação).
+// 'prof[i]' é quantos bytes da palavra já foram consumidos ao chegar em 'nos[i]'.
+// Cada aresta consome pelo menos um byte e a árvore só tem nós de bifurcação ou de término,
+// então o limite só é atingido com mais de MAX_CAMINHO_REMOCAO bifurcações numa mesma palavra.
+#define MAX_CAMINHO_REMOCAO 256
+
+typedef struct CaminhoRemocao
+{
+    int tamanho;
+    int prof[MAX_CAMINHO_REMOCAO];
+    ArvoreTrie *nos[MAX_CAMINHO_REMOCAO];
+} CaminhoRemocao;
+
+// Remove 'texto' descendo a partir do topo de 'caminho' (que deve conter só nós ainda válidos
+// para este texto; vazio = começa da raiz). Sem recursão: a poda é um único corte no ancestral
+// mais fundo que continua necessário (é palavra ou bifurca), seguido da fusão dele com o filho
+// que sobrou, se ele ficou com um filho só.
+// Ao final, 'caminho' contém apenas os nós que continuam na árvore, para reaproveitar na próxima remoção.
+bool RemoveComCaminho(ArvoreTrie **arv, CaminhoRemocao *caminho, unsigned char *texto)
+{
+    int comprimento = strlen((char *)texto);
+
+    if (*arv == NULL)
+    {
+        caminho->tamanho = 0;
+        return false;
+    }
+    if (caminho->tamanho == 0)
+    {
+        caminho->nos[0] = *arv;
+        caminho->prof[0] = 0;
+        caminho->tamanho = 1;
+    }
+
+    ArvoreTrie **nos = caminho->nos;
+    ArvoreTrie *no = nos[caminho->tamanho - 1];
+    int i = caminho->prof[caminho->tamanho - 1];
+    while (i < comprimento)
+    {
+        ArvoreTrie *filho = ObtemFilho(no, texto[i]);
+        if (filho == NULL || filho->tam_rotulo > comprimento - i ||
+            memcmp(filho->rotulo, texto + i, filho->tam_rotulo) != 0)
+            return false;
+
+        if (caminho->tamanho == MAX_CAMINHO_REMOCAO)
+        {
+            // Caminho fundo demais para a pilha fixa: usa a versão recursiva
+            bool removido = false;
+            ArenaTrie *arena = (*arv)->arena;
+            *arv = RemoveArvRec(*arv, texto, &removido);
+            if (*arv == NULL)
+                ArenaDestroi(arena); // a árvore ficou vazia: a arena vai junto com a raiz
+            caminho->tamanho = 0;
+            return removido;
+        }
+        no = filho;
+        i += no->tam_rotulo;
+        nos[caminho->tamanho] = no;
+        caminho->prof[caminho->tamanho] = i;
+        caminho->tamanho++;
+    }
+
+    if (!no->termino)
+        return false;
+    no->termino = 0;
+
+    int alvo = caminho->tamanho - 1;
+    int validos; // nós do caminho que continuam na árvore
+
+    if (no->num_filhos > 0)
+    {
+        // O nó continua existindo; se ficou só com um filho, é absorvido por ele
+        validos = alvo + 1;
+        if (alvo > 0 && no->num_filhos == 1)
+        {
+            unsigned char c = no->rotulo[0]; // lido antes: FundeComFilho libera o nó
+            SubstituiFilho(nos[alvo - 1], c, FundeComFilho(no));
+            validos = alvo;
+        }
+    }
+    else if (alvo == 0)
+    {
+        // A raiz era a única palavra (a palavra vazia)
+        LiberaArvore(arv);
+        caminho->tamanho = 0;
+        return true;
+    }
+    else
+    {
+        // Ponto de corte: ancestral mais fundo que é palavra ou tem outros filhos
+        int corte = alvo - 1;
+        while (corte > 0 && !nos[corte]->termino && nos[corte]->num_filhos == 1)
+            corte--;
+
+        unsigned char c = nos[corte + 1]->rotulo[0];
+        for (int j = alvo; j > corte; j--)
+            LiberaNo(nos[j]);
+        RemoveFilho(nos[corte], c);
+
+        ArvoreTrie *ramo = nos[corte];
+        validos = corte + 1;
+        if (corte == 0 && !ramo->termino && ramo->num_filhos == 0)
+        {
+            LiberaArvore(arv);
+            caminho->tamanho = 0;
+            return true;
+        }
+        if (corte > 0 && !ramo->termino && ramo->num_filhos == 1)
+        {
+            // Re-junta as arestas que ficaram sem bifurcação
+            c = ramo->rotulo[0];
+            SubstituiFilho(nos[corte - 1], c, FundeComFilho(ramo));
+            validos = corte;
+        }
+    }
+
+    // A palavra removida pode estar no cache dos ancestrais
+    for (int j = validos - 1; j >= 0; j--)
+    {
+        if (nos[j]->topk != NULL)
+            RecalculaCacheTopK(nos[j]);
+    }
+    caminho->tamanho = validos;
+    return true;
+}
+
+bool RemoveArv(ArvoreTrie **arv, char *texto)
+{
+    CaminhoRemocao caminho;
+    caminho.tamanho = 0;
+    return RemoveComCaminho(arv, &caminho, (unsigned char *)texto);
+}
+
+// Remove várias palavras de uma vez. Entre uma palavra e a seguinte, o caminho já percorrido é
+// mantido até o tamanho do prefixo comum das duas, e a descida recomeça dali em vez da raiz.
+// Funciona em qualquer ordem, mas com as palavras ordenadas o prefixo comum é o maior possível.
+// Retorna quantas palavras foram removidas.
+int RemoveTodas(ArvoreTrie **arv, char **chaves, int quantidade)
+{
+    CaminhoRemocao caminho;
+    caminho.tamanho = 0;
+    int removidas = 0;
+
+    for (int k = 0; k < quantidade; k++)
+    {
+        if (k > 0)
+        {
+            int comum = TamanhoComum((unsigned char *)chaves[k - 1], strlen(chaves[k - 1]),
+                                     (unsigned char *)chaves[k], strlen(chaves[k]));
+            while (caminho.tamanho > 0 && caminho.prof[caminho.tamanho - 1] > comum)
+                caminho.tamanho--;
+        }
+        removidas += RemoveComCaminho(arv, &caminho, (unsigned char *)chaves[k]);
+    }
+    return removidas;
+}
+
+int ComparaPalavras(const void *a, const void *b)
+{
+    return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+// Remove da árvore todas as palavras de um arquivo texto (mesma separação de CarregaArquivoTexto).
+// As palavras são ordenadas antes, para RemoveTodas aproveitar os prefixos comuns.
+// Retorna quantas foram removidas, ou -1 se o arquivo não pôde ser aberto.
+int RemoveArquivoTexto(ArvoreTrie **arv, const char *nome_arquivo)
+{
+    size_t tamanho;
+    unsigned char *dados = LeArquivoInteiro(nome_arquivo, &tamanho);
+    if (dados == NULL)
+        return -1;
+    if (!classes_prontas)
+        InicializaClassesBytes();
+
+    // Cada palavra é normalizada e terminada com '\0' no próprio texto
+    dados = (unsigned char *)realloc(dados, tamanho + 1);
+    dados[tamanho] = '\0';
+    int quantidade = 0, capacidade = 1024;
+    char **chaves = (char **)malloc(capacidade * sizeof(char *));
+    size_t i = 0;
+    while (i < tamanho)
+    {
+        while (i < tamanho && classe_byte[dados[i]] == 0)
+            i++;
+        if (i == tamanho)
+            break;
+        if (quantidade == capacidade)
+        {
+            capacidade *= 2;
+            chaves = (char **)realloc(chaves, capacidade * sizeof(char *));
+        }
+        chaves[quantidade++] = (char *)dados + i;
+        size_t inicio_palavra = i;
+        while (i < tamanho && classe_byte[dados[i]] != 0)
+        {
+            dados[i] = classe_byte[dados[i]];
+            i++;
+        }
+        MaiusculasUtf8(dados + inicio_palavra, i - inicio_palavra);
+        dados[i++] = '\0';
+    }
+
+    qsort(chaves, quantidade, sizeof(char *), ComparaPalavras);
+    int removidas = RemoveTodas(arv, chaves, quantidade);
+    free(chaves);
+    free(dados);
+    return removidas;
+}
+
+// Verifica se existe pelo menos uma palavra na árvore Trie que começa com um dado prefixo.
+// Percorre a árvore caractere a caractere do prefixo.
+// Para cada caractere, verifica se o nó filho correspondente existe.
+// Se em algum ponto o nó filho não existir, não há nenhuma palavra com este prefixo na árvore, retorna false.
+// Se percorrer todo o prefixo com sucesso, significa que o caminho para o prefixo existe na árvore.
+// Retorna true, indicando que existe pelo menos um caminho (e possivelmente palavras) a partir do nó que representa o fim do prefixo.
+bool VerificaPrefixo(ArvoreTrie *arv, char *prefixo)
+{
+    unsigned char *caracter = (unsigned char *)prefixo;
+    int comprimento = strlen(prefixo);
+
+    if (comprimento == 0)
+    {
+        if (arv == NULL)
+            return false;
+        return arv->termino || no_tem_filho(arv);
+    }
+
+    int sobra;
+    return LocalizaPrefixo(arv, caracter, comprimento, &sobra) != NULL;
+}
+
+void VisualizaArvoreRec(ArvoreTrie *no_atual, int nivel)
+{
+    if (no_atual == NULL)
+    {
+        return;
+    }
+
+    // Imprimir indentação
+    for (int i = 0; i < nivel; i++)
+    {
+        printf("  "); // Dois espaços por nível para indentação
+    }
+
+    // Imprimir o rótulo da aresta que leva a este nó (ignorando para a raiz)
+    if (nivel > 0)
+    {
+        printf("'%.*s'", no_atual->tam_rotulo, (char *)no_atual->rotulo);
+    }
+    else
+    {
+        printf("Raiz");
+    }
+
+    // Indicar se este nó marca o fim de uma palavra
+    if (no_atual->termino)
+    {
+        printf(" *");
+    }
+
+    printf("\n");
+
+    // Chamar recursivamente para cada filho
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(no_atual, &pos, &c, &filho))
+    {
+        VisualizaArvoreRec(filho, nivel + 1);
+    }
+}
+
+// Função wrapper para iniciar a visualização da árvore
+void VisualizaArvore(ArvoreTrie *arv)
+{
+    if (arv == NULL)
+    {
+        printf("Arvore Vazia\n");
+        return;
+    }
+
+    printf("\nVisualizacao da Arvore Trie:\n");
+    // Começa da raiz (nível 0), sem aresta vinda do pai
+    VisualizaArvoreRec(arv, 0);
+}
+
+// Contadores de memória da árvore, por tipo de nó.
+typedef struct EstatisticasTrie
+{
+    long nos;
+    long folhas;
+    long por_tipo[4];
+    long bytes;
+    long bytes_rotulos; // soma dos rótulos = nós que a trie sem compressão precisaria
+} EstatisticasTrie;
+
+// Bytes ocupados pelos vetores de filhos de cada tipo de nó
+long BytesVetoresFilhos(ArvoreTrie *arv)
+{
+    if (arv->filhos == NULL)
+        return 0;
+    long bytes = capacidade_tipo[arv->tipo] * (long)sizeof(ArvoreTrie *);
+    if (arv->tipo == NO48)
+        bytes += NUM_CHARS;
+    else if (arv->tipo != NO256)
+        bytes += capacidade_tipo[arv->tipo];
+    return bytes;
+}
+
+void ColetaEstatisticasRec(ArvoreTrie *arv, EstatisticasTrie *estatisticas)
+{
+    estatisticas->nos++;
+    estatisticas->bytes += sizeof(ArvoreTrie) + BytesVetoresFilhos(arv) + arv->tam_rotulo;
+    if (arv->topk != NULL)
+        estatisticas->bytes += sizeof(CacheTopK);
+    estatisticas->bytes_rotulos += arv->tam_rotulo;
+    if (arv->num_filhos == 0)
+        estatisticas->folhas++;
+    else
+        estatisticas->por_tipo[arv->tipo]++;
+
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(arv, &pos, &c, &filho))
+    {
+        ColetaEstatisticasRec(filho, estatisticas);
+    }
+}
+
+// Mostra quantos nós de cada tipo existem e a memória usada,
+// comparando com o layout antigo de 256 ponteiros por nó.
+void MostraEstatisticas(ArvoreTrie *arv)
+{
+    if (arv == NULL)
+    {
+        printf("Arvore Vazia\n");
+        return;
+    }
+
+    EstatisticasTrie estatisticas = {0};
+    ColetaEstatisticasRec(arv, &estatisticas);
+
+    // Sem compressão, cada byte de rótulo seria um nó de 256 ponteiros
+    long nos_sem_compressao = estatisticas.bytes_rotulos + 1;
+    long bytes_layout_antigo = nos_sem_compressao * (long)(NUM_CHARS * sizeof(ArvoreTrie *) + sizeof(bool));
+    printf("Nos: %ld (folhas: %ld, NO4: %ld, NO16: %ld, NO48: %ld, NO256: %ld)\n",
+           estatisticas.nos, estatisticas.folhas, estatisticas.por_tipo[NO4], estatisticas.por_tipo[NO16],
+           estatisticas.por_tipo[NO48], estatisticas.por_tipo[NO256]);
+    printf("Memoria: %ld bytes (trie sem compressao com 256 ponteiros usaria %ld nos e %ld bytes)\n",
+           estatisticas.bytes, nos_sem_compressao, bytes_layout_antigo);
+}
+
+// ---------------------------------------------------------------------------
+// Trie congelada (double-array) para dicionários somente leitura.
+// Cada estado s tem BASE[s] e CHECK[s]: a transição pelo byte c vai para t = BASE[s] + codigo(c)
+// e só é válida se CHECK[t] == s. O código 0 é o marcador de fim de palavra.
+// Os códigos vêm de uma tabela de classes calculada a partir das palavras congeladas: só os bytes
+// que aparecem recebem código (1..tamanho do alfabeto, na ordem dos bytes). Com texto UTF-8 ou só
+// letras o alfabeto tem poucas dezenas de símbolos em vez de 256, então os filhos de um estado
+// ficam próximos e os vetores ficam bem mais densos.
+// Sufixos que não se bifurcam mais (as folhas da árvore comprimida) ficam inteiros num vetor
+// de cauda: BASE negativo indica uma folha cujo resto da palavra começa em cauda[-BASE - 1].
+// Os três vetores são contíguos e sem ponteiros, então vão direto para um arquivo e voltam via mmap.
+// ---------------------------------------------------------------------------
+
+#define CHECK_LIVRE -1
+#define CHECK_RAIZ -2
+#define MAGICA_TRIE_ESTATICA "TRIEDA2"
+
+typedef struct CabecalhoTrieEstatica
+{
+    char magica[8];
+    int32_t num_estados;
+    int32_t tam_cauda;
+    int32_t num_palavras;
+    int32_t tam_alfabeto;
+    uint16_t classe[NUM_CHARS];
+} CabecalhoTrieEstatica;
+
+typedef struct TrieEstatica
+{
+    int32_t num_estados;
+    int32_t tam_cauda;
+    int32_t num_palavras;
+    int32_t tam_alfabeto;
+    uint16_t classe[NUM_CHARS]; // código de cada byte; 0 = byte que não aparece em nenhuma palavra
+    int32_t *base;
+    int32_t *check;
+    unsigned char *cauda;
+
+    // Construção: capacidade dos vetores e primeira posição possivelmente livre
+    int32_t capacidade;
+    int32_t capacidade_cauda;
+    int32_t primeiro_livre;
+
+    // Quando carregada de arquivo, os vetores apontam para dentro do mapeamento
+    void *mapeamento;
+    size_t tam_mapeamento;
+} TrieEstatica;
+
+int CodigoByte(TrieEstatica *estatica, unsigned char c)
+{
+    return estatica->classe[c];
+}
+
+void MarcaBytesRec(ArvoreTrie *arv, bool *usados)
+{
+    for (int i = 0; i < arv->tam_rotulo; i++)
+        usados[arv->rotulo[i]] = true;
+
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(arv, &pos, &c, &filho))
+    {
+        MarcaBytesRec(filho, usados);
+    }
+}
+
+// Monta a tabela de classes com os bytes que aparecem na árvore, preservando a ordem dos bytes.
+void CalculaAlfabeto(TrieEstatica *estatica, ArvoreTrie *arv)
+{
+    bool usados[NUM_CHARS] = {false};
+    if (arv != NULL)
+        MarcaBytesRec(arv, usados);
+
+    estatica->tam_alfabeto = 0;
+    for (int c = 0; c < NUM_CHARS; c++)
+        estatica->classe[c] = usados[c] ? ++estatica->tam_alfabeto : 0;
+}
+
+// Garante que os vetores tenham pelo menos 'tamanho' posições (as novas ficam livres).
+void GaranteEstados(TrieEstatica *estatica, int32_t tamanho)
+{
+    if (tamanho <= estatica->capacidade)
+        return;
+
+    int32_t nova = estatica->capacidade ? estatica->capacidade : 1024;
+    while (nova < tamanho)
+        nova *= 2;
+    estatica->base = (int32_t *)realloc(estatica->base, nova * sizeof(int32_t));
+    estatica->check = (int32_t *)realloc(estatica->check, nova * sizeof(int32_t));
+    for (int32_t i = estatica->capacidade; i < nova; i++)
+    {
+        estatica->base[i] = 0;
+        estatica->check[i] = CHECK_LIVRE;
+    }
+    estatica->capacidade = nova;
+}
+
+// Guarda um sufixo na cauda (terminado em '\0') e retorna o BASE negativo que aponta para ele.
+int32_t GuardaCauda(TrieEstatica *estatica, const unsigned char *sufixo, int tamanho)
+{
+    if (estatica->tam_cauda + tamanho + 1 > estatica->capacidade_cauda)
+    {
+        while (estatica->tam_cauda + tamanho + 1 > estatica->capacidade_cauda)
+            estatica->capacidade_cauda = estatica->capacidade_cauda ? estatica->capacidade_cauda * 2 : 1024;
+        estatica->cauda = (unsigned char *)realloc(estatica->cauda, estatica->capacidade_cauda);
+    }
+    int32_t posicao = estatica->tam_cauda;
+    if (tamanho > 0)
+        memcpy(estatica->cauda + posicao, sufixo, tamanho);
+    estatica->cauda[posicao + tamanho] = '\0';
+    estatica->tam_cauda += tamanho + 1;
+    return -posicao - 1;
+}
+
+// Procura o menor BASE >= 1 em que todas as posições BASE + codigos[i] estão livres.
+// A busca começa em 'primeiro_livre'; quando o trecho percorrido até achar a base já está quase
+// todo ocupado (95%), 'primeiro_livre' avança até ali, para as próximas buscas não o varrerem de novo.
+int32_t EncontraBase(TrieEstatica *estatica, const int *codigos, int quantidade)
+{
+    while (estatica->primeiro_livre < estatica->capacidade && estatica->check[estatica->primeiro_livre] != CHECK_LIVRE)
+        estatica->primeiro_livre++;
+
+    int32_t posicao = estatica->primeiro_livre;
+    int32_t ocupadas = 0;
+    while (true)
+    {
+        GaranteEstados(estatica, posicao + 1);
+        if (estatica->check[posicao] != CHECK_LIVRE)
+        {
+            ocupadas++;
+        }
+        else if (posicao - codigos[0] >= 1)
+        {
+            int32_t base = posicao - codigos[0];
+            GaranteEstados(estatica, base + codigos[quantidade - 1] + 1);
+            int i = 1;
+            while (i < quantidade && estatica->check[base + codigos[i]] == CHECK_LIVRE)
+                i++;
+            if (i == quantidade)
+            {
+                if (ocupadas >= (posicao - estatica->primeiro_livre + 1) * 0.95)
+                    estatica->primeiro_livre = posicao;
+                return base;
+            }
+        }
+        posicao++;
+    }
+}
+
+// Preenche o estado 's', que corresponde a ter consumido 'consumido' bytes do rótulo de 'no'.
+void ConstroiEstado(TrieEstatica *estatica, int32_t s, ArvoreTrie *no, int consumido)
+{
+    // Folha da árvore comprimida: o resto do rótulo vai inteiro para a cauda
+    if (no->num_filhos == 0 && no->termino)
+    {
+        estatica->base[s] = GuardaCauda(estatica, no->rotulo + consumido, no->tam_rotulo - consumido);
+        return;
+    }
+
+    // No meio de um rótulo com filhos: uma única transição para o próximo byte
+    if (consumido < no->tam_rotulo)
+    {
+        int codigo = CodigoByte(estatica, no->rotulo[consumido]);
+        int32_t base = EncontraBase(estatica, &codigo, 1);
+        estatica->base[s] = base;
+        estatica->check[base + codigo] = s;
+        ConstroiEstado(estatica, base + codigo, no, consumido + 1);
+        return;
+    }
+
+    // No próprio nó: uma transição por filho, mais o marcador de fim se o nó é palavra
+    int codigos[NUM_CHARS + 1];
+    ArvoreTrie *filhos[NUM_CHARS];
+    int quantidade = 0;
+    if (no->termino)
+        codigos[quantidade++] = 0;
+
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    int num_filhos = 0;
+    while (ProximoFilho(no, &pos, &c, &filho))
+    {
+        filhos[num_filhos++] = filho;
+        codigos[quantidade++] = CodigoByte(estatica, c);
+    }
+    if (quantidade == 0)
+    {
+        estatica->base[s] = 1; // árvore vazia: raiz sem transições
+        return;
+    }
+
+    // Reserva todas as posições antes de descer, para que os filhos não as ocupem
+    int32_t base = EncontraBase(estatica, codigos, quantidade);
+    estatica->base[s] = base;
+    for (int i = 0; i < quantidade; i++)
+        estatica->check[base + codigos[i]] = s;
+
+    int i = 0;
+    if (no->termino)
+    {
+        estatica->base[base] = GuardaCauda(estatica, NULL, 0);
+        i = 1;
+    }
+    for (int f = 0; f < num_filhos; f++, i++)
+        ConstroiEstado(estatica, base + codigos[i], filhos[f], 1);
+}
 
-    for (int i = 0; i < comprimento; i++)
+int ContaPalavrasRec(ArvoreTrie *arv)
+{
+    int total = arv->termino ? 1 : 0;
+    int pos = 0;
+    unsigned char c;
+    ArvoreTrie *filho;
+    while (ProximoFilho(arv, &pos, &c, &filho))
     {
-        if (tmp->filhos[caracter[i]] == NULL)
-        {
-            tmp->filhos[caracter[i]] = CriaArvore();
-        }
-        tmp = tmp->filhos[caracter[i]];
+        total += ContaPalavrasRec(filho);
     }
+    return total;
+}
+
+// Converte a árvore (mutável) numa trie congelada em double-array.
+// A árvore original não é alterada e pode ser liberada depois.
+TrieEstatica *CongelaArvore(ArvoreTrie *arv)
+{
+    TrieEstatica *estatica = (TrieEstatica *)calloc(1, sizeof(TrieEstatica));
+    GaranteEstados(estatica, 1);
+    estatica->check[0] = CHECK_RAIZ;
+    estatica->primeiro_livre = 1;
+    CalculaAlfabeto(estatica, arv);
 
-    if (tmp->termino)
+    if (arv != NULL)
     {
-        return false;
+        estatica->num_palavras = ContaPalavrasRec(arv);
+        ConstroiEstado(estatica, 0, arv, 0);
     }
     else
     {
-        tmp->termino = true;
-        return true;
+        estatica->base[0] = 1;
     }
+
+    // Corta os vetores no último estado usado
+    int32_t ultimo = estatica->capacidade - 1;
+    while (ultimo > 0 && estatica->check[ultimo] == CHECK_LIVRE)
+        ultimo--;
+    estatica->num_estados = ultimo + 1;
+    estatica->base = (int32_t *)realloc(estatica->base, estatica->num_estados * sizeof(int32_t));
+    estatica->check = (int32_t *)realloc(estatica->check, estatica->num_estados * sizeof(int32_t));
+    if (estatica->tam_cauda == 0)
+        GuardaCauda(estatica, NULL, 0);
+    return estatica;
 }
 
-// Função recursiva auxiliar para imprimir todas as palavras na árvore Trie.
-// Percorre a árvore em profundidade.
-// 'no_atual': o nó sendo visitado no momento.
-// 'prefixo': o caminho (string) percorrido da raiz até o nó atual.
-// 'comprimento': o comprimento atual do prefixo.
-// Quando um nó tem 'termino' = true, significa que o 'prefixo' atual forma uma palavra válida na árvore, e ela é impressa.
-// Em seguida, itera por todos os possíveis caracteres (0 a NUM_CHARS-1).
-// Se um filho para um caractere específico existir, adiciona o caractere ao prefixo e chama recursivamente a função para o nó filho.
-void ImprimeArvoreRec(ArvoreTrie *arv, unsigned char *prefixo, int comprimento)
+// Transição do estado 's' pelo byte 'c'; retorna -1 se não existir.
+int32_t TransicaoEstatica(TrieEstatica *estatica, int32_t s, unsigned char c)
 {
-    unsigned char novoprefixo[comprimento + 2];
-    memcpy(novoprefixo, prefixo, comprimento);
-    novoprefixo[comprimento + 1] = 0;
+    int codigo = CodigoByte(estatica, c);
+    if (codigo == 0)
+        return -1; // byte fora do alfabeto: nenhuma palavra o contém
+    int32_t t = estatica->base[s] + codigo;
+    if (t >= estatica->num_estados || estatica->check[t] != s)
+        return -1;
+    return t;
+}
 
-    if (arv->termino)
+// Mesma semântica de procurarNaArvore, sobre a trie congelada.
+bool ProcuraNaArvoreEstatica(TrieEstatica *estatica, char *texto)
+{
+    unsigned char *caracter = (unsigned char *)texto;
+    int32_t s = 0;
+
+    for (int i = 0; caracter[i] != '\0'; i++)
     {
-        printf("Palavra: %s\n", prefixo);
+        if (estatica->base[s] < 0)
+            return strcmp((char *)estatica->cauda - estatica->base[s] - 1, (char *)caracter + i) == 0;
+        s = TransicaoEstatica(estatica, s, caracter[i]);
+        if (s < 0)
+            return false;
     }
 
-    for (int i = 0; i < NUM_CHARS; i++)
+    if (estatica->base[s] < 0)
+        return estatica->cauda[-estatica->base[s] - 1] == '\0';
+    int32_t fim = estatica->base[s];
+    return fim < estatica->num_estados && estatica->check[fim] == s;
+}
+
+// Mesma semântica de VerificaPrefixo, sobre a trie congelada.
+bool VerificaPrefixoEstatico(TrieEstatica *estatica, char *prefixo)
+{
+    unsigned char *caracter = (unsigned char *)prefixo;
+    int32_t s = 0;
+
+    if (caracter[0] == '\0')
+        return estatica->num_palavras > 0;
+
+    for (int i = 0; caracter[i] != '\0'; i++)
     {
-        if (arv->filhos[i] != NULL)
+        if (estatica->base[s] < 0)
         {
-            novoprefixo[comprimento] = i;
-            ImprimeArvoreRec(arv->filhos[i], novoprefixo, comprimento + 1);
+            // Numa folha: o resto do prefixo tem que ser começo da cauda
+            const char *cauda = (char *)estatica->cauda - estatica->base[s] - 1;
+            size_t restante = strlen((char *)caracter + i);
+            return strlen(cauda) >= restante && memcmp(cauda, caracter + i, restante) == 0;
         }
+        s = TransicaoEstatica(estatica, s, caracter[i]);
+        if (s < 0)
+            return false;
     }
+    return true;
 }
 
-void ImprimeArvore(ArvoreTrie *arv)
+// Grava a trie congelada: cabeçalho (com a tabela de classes), BASE, CHECK e cauda, em sequência.
+bool SalvaTrieEstatica(TrieEstatica *estatica, const char *nome_arquivo)
 {
-    if (arv == NULL)
-    {
-        printf("Arvore Vazia\n");
-        return;
-    }
+    FILE *arquivo = fopen(nome_arquivo, "wb");
+    if (arquivo == NULL)
+        return false;
 
-    unsigned char prefixo[1] = {0};
-    ImprimeArvoreRec(arv, prefixo, 0);
+    CabecalhoTrieEstatica cabecalho = {MAGICA_TRIE_ESTATICA, estatica->num_estados, estatica->tam_cauda,
+                                       estatica->num_palavras, estatica->tam_alfabeto, {0}};
+    memcpy(cabecalho.classe, estatica->classe, sizeof(cabecalho.classe));
+    bool ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+              fwrite(estatica->base, sizeof(int32_t), estatica->num_estados, arquivo) == (size_t)estatica->num_estados &&
+              fwrite(estatica->check, sizeof(int32_t), estatica->num_estados, arquivo) == (size_t)estatica->num_estados &&
+              fwrite(estatica->cauda, 1, estatica->tam_cauda, arquivo) == (size_t)estatica->tam_cauda;
+    fclose(arquivo);
+    return ok;
 }
 
-bool procurarNaArvore(ArvoreTrie *arv, char *texto)
+void LiberaTrieEstatica(TrieEstatica *estatica)
 {
-    unsigned char *caracter = (unsigned char *)texto;
-    int comprimento = strlen(texto);
-    ArvoreTrie *tmp = arv;
+    if (estatica == NULL)
+        return;
 
-    for (int i = 0; i < comprimento; i++)
+    if (estatica->mapeamento != NULL)
     {
-        if (tmp->filhos[caracter[i]] == NULL)
-        {
-            return false;
-        }
-        tmp = tmp->filhos[caracter[i]];
+#ifdef _WIN32
+        free(estatica->mapeamento);
+#else
+        munmap(estatica->mapeamento, estatica->tam_mapeamento);
+#endif
     }
-    return tmp->termino;
+    else
+    {
+        free(estatica->base);
+        free(estatica->check);
+        free(estatica->cauda);
+    }
+    free(estatica);
 }
 
-bool no_tem_filho(ArvoreTrie *arv)
+// Confere os vetores de uma trie congelada vinda de arquivo, já que as buscas usam os valores
+// como índices sem testar: BASE não negativo é a base das transições (no máximo num_estados, o que
+// também evita estouro em base + código), BASE negativo é uma posição da cauda, CHECK é um estado
+// ou uma das marcas, e as classes não passam do tamanho do alfabeto.
+bool ValidaTrieEstatica(TrieEstatica *estatica)
 {
-    if (arv == NULL)
+    if (estatica->cauda[estatica->tam_cauda - 1] != '\0')
+        return false; // toda cauda termina num '\0' antes do fim do vetor
+    if (estatica->check[0] != CHECK_RAIZ)
         return false;
-    for (int i = 0; i < NUM_CHARS; i++)
+    for (int c = 0; c < NUM_CHARS; c++)
+        if (estatica->classe[c] > estatica->tam_alfabeto)
+            return false;
+    for (int32_t s = 0; s < estatica->num_estados; s++)
     {
-        if (arv->filhos[i] != NULL)
-        {
-            return true;
-        }
+        int32_t base = estatica->base[s], check = estatica->check[s];
+        if (base > estatica->num_estados || (base < 0 && base < -estatica->tam_cauda))
+            return false;
+        if (check != CHECK_LIVRE && check != CHECK_RAIZ && (check < 0 || check >= estatica->num_estados))
+            return false;
     }
-    return false;
+    return true;
 }
 
-ArvoreTrie *RemoveArvRec(ArvoreTrie *arv, unsigned char *texto, bool *removido)
+// Carrega uma trie congelada de arquivo. Com mmap, os vetores apontam direto para as páginas
+// do arquivo (nada é copiado nem reconstruído); no Windows o arquivo é lido para a memória.
+// O cabeçalho e os vetores são conferidos (ValidaTrieEstatica) antes de a trie ser usada.
+TrieEstatica *CarregaTrieEstatica(const char *nome_arquivo)
 {
-    if (arv == NULL)
-        return arv;
+    unsigned char *dados = NULL;
+    size_t tamanho = 0;
+    TrieEstatica *estatica = (TrieEstatica *)calloc(1, sizeof(TrieEstatica));
 
-    if (*texto == '\0')
+#ifdef _WIN32
+    FILE *arquivo = fopen(nome_arquivo, "rb");
+    if (arquivo == NULL)
     {
-        if (arv->termino)
-        {
-            arv->termino = false;
-            *removido = true;
-            if (!no_tem_filho(arv))
-            {
-                free(arv);
-                arv = NULL;
-            }
-        }
-        return arv;
+        free(estatica);
+        return NULL;
     }
+    fseek(arquivo, 0, SEEK_END);
+    tamanho = ftell(arquivo);
+    fseek(arquivo, 0, SEEK_SET);
+    dados = (unsigned char *)malloc(tamanho);
+    if (fread(dados, 1, tamanho, arquivo) != tamanho)
+        tamanho = 0;
+    fclose(arquivo);
+#else
+    int descritor = open(nome_arquivo, O_RDONLY);
+    struct stat informacoes;
+    if (descritor < 0 || fstat(descritor, &informacoes) != 0)
+    {
+        if (descritor >= 0)
+            close(descritor);
+        free(estatica);
+        return NULL;
+    }
+    tamanho = informacoes.st_size;
+    dados = (unsigned char *)mmap(NULL, tamanho, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor);
+    if (dados == MAP_FAILED)
+    {
+        free(estatica);
+        return NULL;
+    }
+#endif
+    estatica->mapeamento = dados;
+    estatica->tam_mapeamento = tamanho;
 
-    arv->filhos[*texto] = RemoveArvRec(arv->filhos[*texto], texto + 1, removido);
-
-    if (*removido && !no_tem_filho(arv) && !arv->termino)
+    CabecalhoTrieEstatica *cabecalho = (CabecalhoTrieEstatica *)dados;
+    // Os campos são testados antes da conta do tamanho: um num_estados negativo viraria um
+    // size_t enorme e a soma poderia dar a volta e coincidir com o tamanho do arquivo
+    if (tamanho < sizeof(CabecalhoTrieEstatica) || memcmp(cabecalho->magica, MAGICA_TRIE_ESTATICA, 8) != 0 ||
+        cabecalho->num_estados <= 0 || cabecalho->tam_cauda <= 0 || cabecalho->num_palavras < 0 ||
+        cabecalho->tam_alfabeto < 0 || cabecalho->tam_alfabeto > NUM_CHARS ||
+        (tamanho - sizeof(CabecalhoTrieEstatica)) / (2 * sizeof(int32_t)) < (size_t)cabecalho->num_estados ||
+        tamanho != sizeof(CabecalhoTrieEstatica) + 2 * sizeof(int32_t) * (size_t)cabecalho->num_estados + (size_t)cabecalho->tam_cauda)
     {
-        free(arv);
-        arv = NULL;
+        LiberaTrieEstatica(estatica);
+        return NULL;
     }
 
-    return arv;
+    estatica->num_estados = cabecalho->num_estados;
+    estatica->tam_cauda = cabecalho->tam_cauda;
+    estatica->num_palavras = cabecalho->num_palavras;
+    estatica->tam_alfabeto = cabecalho->tam_alfabeto;
+    memcpy(estatica->classe, cabecalho->classe, sizeof(estatica->classe));
+    estatica->base = (int32_t *)(dados + sizeof(CabecalhoTrieEstatica));
+    estatica->check = estatica->base + estatica->num_estados;
+    estatica->cauda = (unsigned char *)(estatica->check + estatica->num_estados);
+    if (!ValidaTrieEstatica(estatica))
+    {
+        LiberaTrieEstatica(estatica);
+        return NULL;
+    }
+    return estatica;
 }
 
-bool RemoveArv(ArvoreTrie **arv, char *texto)
+void MostraEstatisticasEstatica(TrieEstatica *estatica)
 {
-    unsigned char *caracter = (unsigned char *)texto;
-    bool resultado = false;
+    long bytes = sizeof(CabecalhoTrieEstatica) + 2 * sizeof(int32_t) * (long)estatica->num_estados + estatica->tam_cauda;
+    printf("Trie congelada: %d palavras, alfabeto de %d bytes, %d estados, %d bytes de cauda, %ld bytes no total",
+           estatica->num_palavras, estatica->tam_alfabeto, estatica->num_estados, estatica->tam_cauda, bytes);
+    if (estatica->num_palavras > 0)
+        printf(" (%.1f bytes por palavra)", (double)bytes / estatica->num_palavras);
+    printf("\n");
+}
 
-    if (*arv == NULL)
-        return false;
+// ---------------------------------------------------------------------------
+// Aho-Corasick: procura todas as palavras da árvore num texto, numa única passada.
+// A compilação copia as palavras para um autômato à parte: a árvore principal tem arestas
+// comprimidas e nós que mudam de tipo, enquanto os links de falha precisam de um estado por prefixo.
+// Os links de falha já são resolvidos na tabela de transições (uma linha por estado, uma coluna
+// por classe de byte), então a busca faz exatamente uma consulta à tabela por byte do texto.
+// Depois de compilada, cada entrada da tabela guarda o deslocamento da linha do destino
+// (estado * tam_alfabeto) multiplicado por 2, com o bit 0 ligado se alguma palavra termina no
+// destino: o laço da busca não multiplica nem consulta outro vetor enquanto não há ocorrência.
+// Bytes que não aparecem em nenhuma palavra caem na classe 0, que sempre volta para a raiz.
+// A busca ignora maiúsculas/minúsculas como MaiusculasUtf8: letras ASCII minúsculas usam a classe da
+// maiúscula, e as acentuadas do Latin-1 (C3 A0 a C3 BE) valem o mesmo que C3 80 a C3 9E. Como
+// A0 a BE também são continuação de outras letras (C4 A0 é Ġ, não Ā), essa troca não vai para as
+// classes: só as linhas dos estados em que se chega por C3 tratam a coluna de A0 a BE como a de 80 a 9E.
+// O estado da busca fica numa estrutura própria, então o texto pode chegar em blocos de qualquer
+// tamanho (ocorrências que atravessam a fronteira entre blocos também são encontradas).
+// ---------------------------------------------------------------------------
 
-    *arv = RemoveArvRec(*arv, caracter, &resultado);
-    return resultado;
-}
-// Verifica se existe pelo menos uma palavra na árvore Trie que começa com um dado prefixo.
-// Percorre a árvore caractere a caractere do prefixo.
-// Para cada caractere, verifica se o nó filho correspondente existe.
-// Se em algum ponto o nó filho não existir, não há nenhuma palavra com este prefixo na árvore, retorna false.
-// Se percorrer todo o prefixo com sucesso, significa que o caminho para o prefixo existe na árvore.
-// Retorna true, indicando que existe pelo menos um caminho (e possivelmente palavras) a partir do nó que representa o fim do prefixo.
-bool VerificaPrefixo(ArvoreTrie *arv, char *prefixo)
+typedef struct AutomatoAC
 {
-    unsigned char *caracter = (unsigned char *)prefixo;
-    int comprimento = strlen(prefixo);
+    int32_t num_estados;
+    int32_t capacidade;
+    int tam_alfabeto;          // colunas da tabela, incluindo a classe 0
+    uint16_t classe[NUM_CHARS];
+    int32_t *transicao;        // transicao[estado * tam_alfabeto + classe], codificada como descrito acima
+    int32_t *falha;            // maior sufixo próprio do estado que também é prefixo de alguma palavra
+    int32_t *saida;            // palavra que termina exatamente neste estado (-1 = nenhuma)
+    int32_t *proxima_saida;    // próximo estado na cadeia de falhas que tem palavra (-1 = nenhum)
+    char **palavras;
+    int *tam_palavras;
+    int num_palavras;
+    int capacidade_palavras;
+} AutomatoAC;
+
+// Estado de uma busca em andamento, mantido entre um bloco e o próximo
+typedef struct BuscaAC
+{
+    AutomatoAC *automato;
+    int32_t linha; // deslocamento da linha do estado atual na tabela
+    long long consumidos; // bytes já processados (posição do início do próximo bloco)
+    long long ocorrencias;
+} BuscaAC;
+
+// Retorno de chamada para cada ocorrência: a palavra, o índice dela no autômato e a posição
+// (em bytes, desde o início do texto) onde a ocorrência começa. Retornar false interrompe a busca.
+typedef bool (*CallbackOcorrencia)(const char *palavra, int indice, long long posicao, void *contexto);
 
+bool GuardaPalavraAC(const char *palavra, int comprimento, unsigned int frequencia, void *contexto)
+{
+    AutomatoAC *automato = (AutomatoAC *)contexto;
+    (void)frequencia;
     if (comprimento == 0)
+        return true; // a palavra vazia ocorreria em toda posição
+    if (automato->num_palavras == automato->capacidade_palavras)
     {
-        if (arv == NULL)
-            return false;
-        return arv->termino || no_tem_filho(arv);
+        automato->capacidade_palavras = automato->capacidade_palavras ? automato->capacidade_palavras * 2 : 64;
+        automato->palavras = (char **)realloc(automato->palavras, automato->capacidade_palavras * sizeof(char *));
+        automato->tam_palavras = (int *)realloc(automato->tam_palavras, automato->capacidade_palavras * sizeof(int));
     }
+    automato->palavras[automato->num_palavras] = (char *)malloc(comprimento + 1);
+    memcpy(automato->palavras[automato->num_palavras], palavra, comprimento + 1);
+    automato->tam_palavras[automato->num_palavras] = comprimento;
+    automato->num_palavras++;
+    return true;
+}
 
-    if (arv == NULL)
-        return false;
+// Byte 'c' de uma palavra com a caixa dobrada, dado o byte anterior (0 no início).
+bool MinusculaLatin1AC(unsigned char anterior, unsigned char c)
+{
+    return anterior == 0xC3 && c >= 0xA0 && c <= 0xBE && c != 0xB7;
+}
 
-    ArvoreTrie *tmp = arv;
+unsigned char DobraCaixaAC(unsigned char anterior, unsigned char c)
+{
+    if (c < 0x80)
+        return (unsigned char)toupper(c);
+    return MinusculaLatin1AC(anterior, c) ? c - 0x20 : c;
+}
 
-    for (int i = 0; i < comprimento; i++)
+// Cria um estado novo, sem transições (-1) e sem palavra.
+int32_t NovoEstadoAC(AutomatoAC *automato)
+{
+    if (automato->num_estados == automato->capacidade)
     {
-        if (tmp->filhos[caracter[i]] == NULL)
-        {
-            return false;
-        }
-        tmp = tmp->filhos[caracter[i]];
+        automato->capacidade = automato->capacidade ? automato->capacidade * 2 : 256;
+        automato->transicao = (int32_t *)realloc(automato->transicao,
+                                                 (size_t)automato->capacidade * automato->tam_alfabeto * sizeof(int32_t));
+        automato->falha = (int32_t *)realloc(automato->falha, automato->capacidade * sizeof(int32_t));
+        automato->saida = (int32_t *)realloc(automato->saida, automato->capacidade * sizeof(int32_t));
+        automato->proxima_saida = (int32_t *)realloc(automato->proxima_saida, automato->capacidade * sizeof(int32_t));
     }
-    return true;
+    int32_t estado = automato->num_estados++;
+    for (int c = 0; c < automato->tam_alfabeto; c++)
+        automato->transicao[(size_t)estado * automato->tam_alfabeto + c] = -1;
+    automato->falha[estado] = 0;
+    automato->saida[estado] = -1;
+    automato->proxima_saida[estado] = -1;
+    return estado;
 }
 
-void VisualizaArvoreRec(ArvoreTrie *no_atual, char char_vindo_do_pai, int nivel)
+void LiberaAutomatoAC(AutomatoAC *automato)
 {
-    if (no_atual == NULL)
-    {
+    if (automato == NULL)
         return;
-    }
+    for (int p = 0; p < automato->num_palavras; p++)
+        free(automato->palavras[p]);
+    free(automato->palavras);
+    free(automato->tam_palavras);
+    free(automato->transicao);
+    free(automato->falha);
+    free(automato->saida);
+    free(automato->proxima_saida);
+    free(automato);
+}
 
-    // Imprimir indentação
-    for (int i = 0; i < nivel; i++)
-    {
-        printf("  "); // Dois espaços por nível para indentação
-    }
+// Compila o autômato com todas as palavras da árvore.
+// A tabela codificada guarda estado * tam_alfabeto * 2 + 1 num int32_t, então o autômato tem no
+// máximo INT32_MAX / (2 * tam_alfabeto) estados (cerca de 4 milhões com as 257 classes possíveis);
+// acima disso a compilação falha e retorna NULL.
+AutomatoAC *CompilaAhoCorasick(ArvoreTrie *arv)
+{
+    AutomatoAC *automato = (AutomatoAC *)calloc(1, sizeof(AutomatoAC));
+    if (arv != NULL)
+        ColetaComPrefixo(arv, "", 0, GuardaPalavraAC, automato);
 
-    // Imprimir o caractere que leva a este nó (ignorando para a raiz)
-    if (nivel > 0)
+    // Alfabeto: só os bytes (já com a caixa dobrada) que aparecem nas palavras
+    bool usados[NUM_CHARS] = {false};
+    for (int p = 0; p < automato->num_palavras; p++)
+        for (int i = 0; i < automato->tam_palavras[p]; i++)
+            usados[DobraCaixaAC(i > 0 ? automato->palavras[p][i - 1] : 0, automato->palavras[p][i])] = true;
+    // As minúsculas acentuadas precisam de coluna própria para as linhas depois de C3
+    for (int c = 0xA0; c <= 0xBE; c++)
+        if (usados[0xC3] && MinusculaLatin1AC(0xC3, c) && usados[c - 0x20])
+            usados[c] = true;
+    uint16_t codigo[NUM_CHARS];
+    automato->tam_alfabeto = 1;
+    for (int c = 0; c < NUM_CHARS; c++)
+        codigo[c] = usados[c] ? automato->tam_alfabeto++ : 0;
+    for (int c = 0; c < NUM_CHARS; c++)
+        automato->classe[c] = codigo[DobraCaixaAC(0, c)];
+
+    // Goto: a trie das palavras, um estado por prefixo
+    int32_t max_estados = INT32_MAX / (2 * automato->tam_alfabeto);
+    NovoEstadoAC(automato);
+    for (int p = 0; p < automato->num_palavras; p++)
     {
-        printf("'%c'", char_vindo_do_pai);
+        int32_t estado = 0;
+        for (int i = 0; i < automato->tam_palavras[p]; i++)
+        {
+            int c = codigo[DobraCaixaAC(i > 0 ? automato->palavras[p][i - 1] : 0, automato->palavras[p][i])];
+            int32_t proximo = automato->transicao[(size_t)estado * automato->tam_alfabeto + c];
+            if (proximo < 0)
+            {
+                if (automato->num_estados == max_estados)
+                {
+                    LiberaAutomatoAC(automato);
+                    return NULL;
+                }
+                proximo = NovoEstadoAC(automato);
+                automato->transicao[(size_t)estado * automato->tam_alfabeto + c] = proximo;
+            }
+            estado = proximo;
+        }
+        automato->saida[estado] = p;
     }
-    else
+
+    // Falhas em largura: o estado de falha de um filho é a transição, pelo mesmo byte, a partir da
+    // falha do pai, cuja linha já está completa por ser mais rasa. Transições que não existem
+    // copiam a da falha, e a tabela vira um autômato determinístico completo.
+    // Nas linhas dos estados em que se chega por C3, a coluna de cada minúscula acentuada passa a
+    // ser a da maiúscula; isso acontece antes de as linhas mais fundas copiarem desta.
+    int32_t *fila = (int32_t *)malloc(automato->num_estados * sizeof(int32_t));
+    bool *depois_c3 = (bool *)calloc(automato->num_estados, sizeof(bool));
+    int inicio_fila = 0, fim_fila = 0;
+    fila[fim_fila++] = 0;
+    while (inicio_fila < fim_fila)
     {
-        printf("Raiz");
+        int32_t estado = fila[inicio_fila++];
+        int32_t *linha = automato->transicao + (size_t)estado * automato->tam_alfabeto;
+        int32_t *linha_falha = automato->transicao + (size_t)automato->falha[estado] * automato->tam_alfabeto;
+        for (int c = 0; c < automato->tam_alfabeto; c++)
+        {
+            if (linha[c] < 0)
+            {
+                linha[c] = estado == 0 ? 0 : linha_falha[c];
+                continue;
+            }
+            int32_t filho = linha[c];
+            int32_t falha = estado == 0 ? 0 : linha_falha[c];
+            automato->falha[filho] = falha;
+            automato->proxima_saida[filho] = automato->saida[falha] >= 0 ? falha : automato->proxima_saida[falha];
+            depois_c3[filho] = c == codigo[0xC3] && c != 0;
+            fila[fim_fila++] = filho;
+        }
+        if (depois_c3[estado])
+        {
+            for (int b = 0xA0; b <= 0xBE; b++)
+                if (MinusculaLatin1AC(0xC3, b) && codigo[b] != 0)
+                    linha[codigo[b]] = linha[codigo[b - 0x20]];
+        }
     }
+    free(fila);
+    free(depois_c3);
 
-    // Indicar se este nó marca o fim de uma palavra
-    if (no_atual->termino)
+    // Codifica a tabela para a busca
+    size_t entradas = (size_t)automato->num_estados * automato->tam_alfabeto;
+    for (size_t i = 0; i < entradas; i++)
     {
-        printf(" *");
+        int32_t destino = automato->transicao[i];
+        bool tem_saida = automato->saida[destino] >= 0 || automato->proxima_saida[destino] >= 0;
+        automato->transicao[i] = destino * automato->tam_alfabeto * 2 + tem_saida;
     }
+    return automato;
+}
 
-    printf("\n");
+void IniciaBuscaAC(BuscaAC *busca, AutomatoAC *automato)
+{
+    busca->automato = automato;
+    busca->linha = 0;
+    busca->consumidos = 0;
+    busca->ocorrencias = 0;
+}
 
-    // Chamar recursivamente para cada filho
-    for (int i = 0; i < NUM_CHARS; i++)
+// Processa mais um bloco do texto, continuando do estado deixado pelo bloco anterior.
+// Retorna false se o retorno de chamada pediu para parar.
+bool ProcuraBlocoAC(BuscaAC *busca, const unsigned char *bloco, size_t tamanho, CallbackOcorrencia callback,
+                    void *contexto)
+{
+    AutomatoAC *automato = busca->automato;
+    const int32_t *transicao = automato->transicao;
+    const uint16_t *classe = automato->classe;
+    int32_t linha = busca->linha;
+
+    for (size_t i = 0; i < tamanho; i++)
     {
-        if (no_atual->filhos[i] != NULL)
+        int32_t entrada = transicao[linha + classe[bloco[i]]];
+        linha = entrada >> 1;
+        if (!(entrada & 1))
+            continue;
+
+        // Todas as palavras que terminam aqui: a do próprio estado e as da cadeia de saída
+        int32_t estado = linha / automato->tam_alfabeto;
+        int32_t com_saida = automato->saida[estado] >= 0 ? estado : automato->proxima_saida[estado];
+        while (com_saida >= 0)
         {
-            VisualizaArvoreRec(no_atual->filhos[i], (char)i, nivel + 1);
+            int indice = automato->saida[com_saida];
+            long long posicao = busca->consumidos + (long long)i + 1 - automato->tam_palavras[indice];
+            busca->ocorrencias++;
+            if (callback != NULL && !callback(automato->palavras[indice], indice, posicao, contexto))
+            {
+                busca->linha = linha;
+                busca->consumidos += i + 1;
+                return false;
+            }
+            com_saida = automato->proxima_saida[com_saida];
         }
     }
+    busca->linha = linha;
+    busca->consumidos += tamanho;
+    return true;
 }
 
-// Função wrapper para iniciar a visualização da árvore
-void VisualizaArvore(ArvoreTrie *arv)
+// Procura as palavras num arquivo lido em blocos de TAM_BLOCO_LEITURA: a memória usada não
+// depende do tamanho do arquivo. Retorna false se o arquivo não pôde ser aberto.
+bool ProcuraArquivoAC(AutomatoAC *automato, const char *nome_arquivo, BuscaAC *busca, CallbackOcorrencia callback,
+                      void *contexto)
 {
-    if (arv == NULL)
+    FILE *arquivo = fopen(nome_arquivo, "rb");
+    if (arquivo == NULL)
+        return false;
+
+    unsigned char *bloco = (unsigned char *)malloc(TAM_BLOCO_LEITURA);
+    size_t lidos;
+    IniciaBuscaAC(busca, automato);
+    while ((lidos = fread(bloco, 1, TAM_BLOCO_LEITURA, arquivo)) > 0)
     {
-        printf("Arvore Vazia\n");
-        return;
+        if (!ProcuraBlocoAC(busca, bloco, lidos, callback, contexto))
+            break;
     }
+    free(bloco);
+    fclose(arquivo);
+    return true;
+}
 
-    printf("\nVisualizacao da Arvore Trie:\n");
-    // Começa da raiz (nível 0), sem caractere vindo do pai
-    VisualizaArvoreRec(arv, ' ', 0);
+// Imprime as primeiras ocorrências e só conta as demais; o contexto aponta para o limite restante.
+bool ImprimeOcorrencia(const char *palavra, int indice, long long posicao, void *contexto)
+{
+    int *restantes = (int *)contexto;
+    (void)indice;
+    if (*restantes > 0)
+    {
+        printf("Posicao %lld: %s\n", posicao, palavra);
+        (*restantes)--;
+    }
+    return true;
+}
+
+// Tamanho da sequência UTF-8 que começa em 'texto' (2 a 4 bytes), ou 0 se ela for inválida.
+int TamanhoSequenciaUtf8(const unsigned char *texto, int restante)
+{
+    int tamanho;
+    if (texto[0] >= 0xC2 && texto[0] <= 0xDF)
+        tamanho = 2;
+    else if (texto[0] >= 0xE0 && texto[0] <= 0xEF)
+        tamanho = 3;
+    else if (texto[0] >= 0xF0 && texto[0] <= 0xF4)
+        tamanho = 4;
+    else
+        return 0;
+
+    if (tamanho > restante)
+        return 0;
+    for (int i = 1; i < tamanho; i++)
+    {
+        if (texto[i] < 0x80 || texto[i] > 0xBF)
+            return 0;
+    }
+    return tamanho;
+}
+
+// Opções do menu que pedem uma palavra ou prefixo
+bool OpcaoPedePalavra(int opcao)
+{
+    return (opcao >= 1 && opcao <= 5) || (opcao >= 9 && opcao <= 11) || opcao == 16 || opcao == 17 || opcao == 21;
 }
 
 void menu()
@@ -280,6 +2870,22 @@ void menu()
     printf("4. Imprimir todas as palavras\n");
     printf("5. Verificar prefixo\n");
     printf("7. Visualizar Arvore (Estrutura)\n");
+    printf("8. Estatisticas de memoria\n");
+    printf("9. Listar palavras com prefixo\n");
+    printf("10. Autocompletar (mais frequentes)\n");
+    printf("11. Registrar uso de palavra\n");
+    printf("12. Ativar cache de autocompletar\n");
+    printf("13. Liberar arvore inteira\n");
+    printf("14. Congelar arvore e salvar em arquivo\n");
+    printf("15. Carregar arvore congelada de arquivo\n");
+    printf("16. Buscar palavra na arvore congelada\n");
+    printf("17. Verificar prefixo na arvore congelada\n");
+    printf("18. Carregar palavras de arquivo texto (contando frequencias)\n");
+    printf("19. Carregar arquivo texto com varias threads\n");
+    printf("20. Benchmark de insercao concorrente\n");
+    printf("21. Busca aproximada (tolerante a erros de digitacao)\n");
+    printf("22. Remover as palavras de um arquivo texto\n");
+    printf("23. Procurar todas as palavras da arvore num arquivo (Aho-Corasick)\n");
     printf("6. Sair\n");
     printf("Escolha uma opcao: ");
 }
@@ -290,8 +2896,8 @@ int main()
     ArvoreTrie *arvore = NULL;
     int opcao;
     char palavra[100]; // Buffer fixo
-
-    // TODO: Implementar LiberaArvoreRec e chamá-la antes de sair
+    char nome_arquivo[256];
+    TrieEstatica *congelada = NULL;
 
     do
     {
@@ -310,7 +2916,7 @@ int main()
         int comprimento = 0;
 
         // Processa a entrada da palavra para opções que precisam dela
-        if (opcao >= 1 && opcao <= 5)
+        if (OpcaoPedePalavra(opcao))
         {
             printf("Digite a string (apenas letras): ");
             fgets(palavra, sizeof(palavra), stdin);
@@ -322,6 +2928,19 @@ int main()
             for (int i = 0; i < comprimento; i++)
             {
                 unsigned char current_char = palavra[i];
+                // Caracteres fora do ASCII chegam como sequências UTF-8 e são guardados como estão
+                if (current_char >= 0x80)
+                {
+                    int tamanho_sequencia = TamanhoSequenciaUtf8((unsigned char *)palavra + i, comprimento - i);
+                    if (tamanho_sequencia == 0)
+                    {
+                        printf("Erro: Entrada nao e UTF-8 valido. Por favor, digite apenas letras.\n");
+                        input_valido = false;
+                        break;
+                    }
+                    i += tamanho_sequencia - 1;
+                    continue;
+                }
                 // Validação: Usando isalpha() de <ctype.h>
                 if (!isalpha(current_char))
                 {
@@ -332,6 +2951,8 @@ int main()
                 // Conversão: Usando toupper() de <ctype.h>
                 palavra[i] = toupper(current_char); // Converte para maiúscula IN PLACE
             }
+            if (input_valido)
+                MaiusculasUtf8((unsigned char *)palavra, comprimento);
             // --- Fim da Validação e Conversão ---
 
             // Tratar string vazia após a validação/conversão
@@ -347,11 +2968,14 @@ int main()
         {             // Correção na condição: deve ser && opcao <= 5
             continue; // Volta para o início do loop do/while
         }
-        if (opcao >= 1 && opcao <= 5 && !input_valido)
+        if (OpcaoPedePalavra(opcao) && !input_valido)
         {
             continue;
         }
 
+        int limite;
+        ResultadoCarga carga;
+
         switch (opcao)
         {
         case 1:
@@ -406,17 +3030,208 @@ int main()
             printf("Visualizando a arvore com as palavras em MAIUSCULAS:\n");
             VisualizaArvore(arvore); // Visualiza a arvore com caracteres em MAIÚSCULAS
             break;
+        case 8:
+            MostraEstatisticas(arvore);
+            MostraEstatisticasAlocador(arvore);
+            break;
+        case 9:
+            printf("Quantidade maxima de palavras (0 = todas): ");
+            if (scanf("%d", &limite) != 1)
+                limite = 0;
+            if (ColetaComPrefixo(arvore, palavra, limite, ImprimePalavra, NULL) == 0)
+            {
+                printf("Nenhuma palavra com o prefixo!\n");
+            }
+            break;
+        case 10:
+            printf("Quantas sugestoes (ate %d usa o cache): ", TOPK);
+            if (scanf("%d", &limite) != 1)
+                limite = TOPK;
+            if (AutocompletaTopK(arvore, palavra, limite, ImprimePalavraComFrequencia, NULL) == 0)
+            {
+                printf("Nenhuma palavra com o prefixo!\n");
+            }
+            break;
+        case 11:
+            if (RegistraUso(arvore, palavra, 1))
+            {
+                printf("Uso registrado!\n");
+            }
+            else
+            {
+                printf("Palavra nao encontrada!\n");
+            }
+            break;
+        case 12:
+            HabilitaTopK(&arvore);
+            printf("Cache de autocompletar ativo (%d palavras por no)\n", TOPK);
+            break;
+        case 13:
+            LiberaArvore(&arvore);
+            printf("Arvore liberada!\n");
+            break;
+        case 14:
+            printf("Nome do arquivo: ");
+            if (scanf("%255s", nome_arquivo) != 1)
+                break;
+            LiberaTrieEstatica(congelada);
+            congelada = CongelaArvore(arvore);
+            MostraEstatisticasEstatica(congelada);
+            if (SalvaTrieEstatica(congelada, nome_arquivo))
+            {
+                printf("Arvore congelada salva em '%s'!\n", nome_arquivo);
+            }
+            else
+            {
+                printf("Erro ao salvar '%s'!\n", nome_arquivo);
+            }
+            break;
+        case 15:
+            printf("Nome do arquivo: ");
+            if (scanf("%255s", nome_arquivo) != 1)
+                break;
+            LiberaTrieEstatica(congelada);
+            congelada = CarregaTrieEstatica(nome_arquivo);
+            if (congelada != NULL)
+            {
+                MostraEstatisticasEstatica(congelada);
+            }
+            else
+            {
+                printf("Erro ao carregar '%s' (arquivo inexistente ou invalido)!\n", nome_arquivo);
+            }
+            break;
+        case 18:
+            printf("Nome do arquivo: ");
+            if (scanf("%255s", nome_arquivo) != 1)
+                break;
+            if (CarregaArquivoTexto(&arvore, nome_arquivo, &carga))
+            {
+                MostraResultadoCarga(&carga);
+            }
+            else
+            {
+                printf("Erro ao abrir '%s'!\n", nome_arquivo);
+            }
+            break;
+        case 19:
+            printf("Nome do arquivo e numero de threads: ");
+            if (scanf("%255s %d", nome_arquivo, &limite) != 2)
+                break;
+            if (limite < 1 || limite > MAX_THREADS)
+            {
+                printf("Numero de threads deve estar entre 1 e %d!\n", MAX_THREADS);
+                break;
+            }
+            {
+                size_t tamanho;
+                unsigned char *dados = LeArquivoInteiro(nome_arquivo, &tamanho);
+                if (dados == NULL)
+                {
+                    printf("Erro ao abrir '%s'!\n", nome_arquivo);
+                    break;
+                }
+                TrieConcorrente *concorrente = CriaTrieConcorrente();
+                CarregaTextoParalelo(concorrente, dados, tamanho, limite, &carga);
+                MostraResultadoCarga(&carga);
+                TransfereParaArvore(concorrente, &arvore);
+                LiberaTrieConcorrente(concorrente);
+                free(dados);
+            }
+            break;
+        case 20:
+            printf("Nome do arquivo e numero maximo de threads: ");
+            if (scanf("%255s %d", nome_arquivo, &limite) != 2)
+                break;
+            if (limite < 1 || limite > MAX_THREADS)
+            {
+                printf("Numero de threads deve estar entre 1 e %d!\n", MAX_THREADS);
+                break;
+            }
+            BenchmarkConcorrente(nome_arquivo, limite);
+            break;
+        case 21:
+            printf("Distancia maxima: ");
+            if (scanf("%d", &limite) != 1)
+                limite = 1;
+            {
+                long visitados;
+                int encontradas = ProcuraAproximada(arvore, palavra, limite, ImprimePalavraComDistancia, NULL, &visitados);
+                printf("%d palavra(s) encontrada(s), %ld nos visitados\n", encontradas, visitados);
+            }
+            break;
+        case 22:
+            printf("Nome do arquivo: ");
+            if (scanf("%255s", nome_arquivo) != 1)
+                break;
+            limite = RemoveArquivoTexto(&arvore, nome_arquivo);
+            if (limite >= 0)
+            {
+                printf("%d palavra(s) removida(s)!\n", limite);
+            }
+            else
+            {
+                printf("Erro ao abrir '%s'!\n", nome_arquivo);
+            }
+            break;
+        case 23:
+            printf("Nome do arquivo e quantas ocorrencias mostrar: ");
+            if (scanf("%255s %d", nome_arquivo, &limite) != 2)
+                break;
+            {
+                double inicio = RelogioSegundos();
+                AutomatoAC *automato = CompilaAhoCorasick(arvore);
+                if (automato == NULL)
+                {
+                    printf("Palavras demais para o automato!\n");
+                    break;
+                }
+                printf("Automato: %d palavras, %d estados, alfabeto de %d classes\n", automato->num_palavras,
+                       automato->num_estados, automato->tam_alfabeto);
+                double meio = RelogioSegundos();
+                BuscaAC busca;
+                if (ProcuraArquivoAC(automato, nome_arquivo, &busca, ImprimeOcorrencia, &limite))
+                {
+                    double segundos = RelogioSegundos() - meio;
+                    printf("%lld ocorrencia(s) em %lld bytes; compilacao %.3f s, busca %.3f s", busca.ocorrencias,
+                           busca.consumidos, meio - inicio, segundos);
+                    if (segundos > 0)
+                        printf(" (%.1f MB/s)", busca.consumidos / (1024.0 * 1024.0) / segundos);
+                    printf("\n");
+                }
+                else
+                {
+                    printf("Erro ao abrir '%s'!\n", nome_arquivo);
+                }
+                LiberaAutomatoAC(automato);
+            }
+            break;
+        case 16:
+        case 17:
+            if (congelada == NULL)
+            {
+                printf("Nenhuma arvore congelada (use as opcoes 14 ou 15)!\n");
+            }
+            else if (opcao == 16)
+            {
+                printf(ProcuraNaArvoreEstatica(congelada, palavra) ? "Palavra encontrada!\n" : "Palavra nao encontrada!\n");
+            }
+            else
+            {
+                printf(VerificaPrefixoEstatico(congelada, palavra) ? "Existe palavra com o prefixo!\n" : "Nenhum prefixo encontrado!\n");
+            }
+            break;
         case 6:
             printf("Saindo...\n");
-            // TODO: Implementar e chamar LiberaArvoreRec(arvore); aqui
             break;
         default:
             printf("Opcao invalida!\n");
         }
     } while (opcao != 6);
 
-    // TODO: A liberação completa da memória da árvore deve ser implementada e chamada aqui
-    // LiberaArvoreRec(arvore);
+    // Libera toda a memória da árvore
+    LiberaArvore(&arvore);
+    LiberaTrieEstatica(congelada);
 
     return 0;
 }